@@ -28,6 +28,7 @@ class GridObj;
 #include "PCpts.h"
 #include "GridUtils.h"
 #include "MarkerData.h"
+#include "MarkerIndex.h"
 
 
 /// \brief	Generic body class
@@ -71,6 +72,7 @@ protected:
 	int level;							///< Level on which body exists
 
 	std::vector<int> validMarkers;		///< Vector of indices to valid markers within this body which actually exist on this rank
+	MarkerIndex markerIndex;			///< Cell list over the markers for neighbour queries (rebuilt by each user)
 
 
 	// ************************ Methods ************************ //
@@ -81,6 +83,7 @@ protected:
 		int& curr_mark, std::vector<int>& counter);							// Voxelising marker adder
 	void deleteRecvLayerMarkers();											// Delete any markers which are on receiver layer
 	void deleteOffRankMarkers();											// Delete any markers which don't exist on this rank
+	void buildMarkerIndex(double cellWidth);								// Bin the marker positions into cells of the given width
 
 private:
 	bool isInVoxel(double x, double y, double z, int curr_mark);			// Check a point is inside an existing marker voxel
@@ -613,6 +616,21 @@ MarkerData* Body<MarkerType>::getMarkerData(double x, double y, double z) {
 
 };
 
+/*********************************************/
+/// \brief	Bin the marker positions into the cell list.
+///
+///			The cells should be about as wide as the distance over which
+///			markers are sought to keep the number visited small.
+///
+/// \param	cellWidth	width of the cells in physical units
+template <typename MarkerType>
+void Body<MarkerType>::buildMarkerIndex(double cellWidth) {
+
+	markerIndex.reset(cellWidth);
+	for (int m = 0; m < static_cast<int>(markers.size()); m++)
+		markerIndex.insert(markers[m].position, m);
+};
+
 /*********************************************/
 /// \brief	Downsampling voxel-grid filter to take a point and add it to current body
 ///
@@ -620,7 +638,9 @@ MarkerData* Body<MarkerType>::getMarkerData(double x, double y, double z) {
 ///			but obeys the rules of a 1 marker per cell voxel-grid filter to 
 ///			ensure markers are distributed such that their spacing roughly matches 
 ///			the background lattice. It is usually called inside a loop and requires
-///			a few extra pieces of information to be tracked throughout.
+///			a few extra pieces of information to be tracked throughout. 
+///			Existing markers are found through the marker index which must 
+///			hold the markers by primary support voxel.
 ///
 /// \param	x			desired global X-position of new marker
 /// \param	y			desired global Y-position of new marker
@@ -651,8 +671,9 @@ void Body<MarkerType>::passToVoxelFilter(double x, double y, double z, int marke
 	else if (isVoxelMarkerVoxel(x, y, z)) {
 
 		// Recover voxel number
-		MarkerData* m_data = getMarkerData(x, y, z);
-		curr_mark = m_data->ID;
+		std::vector<int> vox;
+		GridUtils::isOnThisRank(x, y, z, nullptr, _Owner, &vox);
+		curr_mark = markerIndex.find(vox[0], vox[1], vox[2])->front();
 
 		// Increment point counter
 		counter[curr_mark]++;
@@ -664,8 +685,6 @@ void Body<MarkerType>::passToVoxelFilter(double x, double y, double z, int marke
 			((markers[curr_mark].position[1] * (counter[curr_mark] - 1)) + y) / counter[curr_mark];
 		markers[curr_mark].position[2] =
 			((markers[curr_mark].position[2] * (counter[curr_mark] - 1)) + z) / counter[curr_mark];
-
-		delete m_data;
 			
 	}
 	// Must be in a new marker voxel
@@ -677,6 +696,7 @@ void Body<MarkerType>::passToVoxelFilter(double x, double y, double z, int marke
 
 		// Create new marker as this is a new marker voxel
 		addMarker(x, y, z, markerID);
+		markerIndex.insert(markers[curr_mark].supp_i[0], markers[curr_mark].supp_j[0], markers[curr_mark].supp_k[0], curr_mark);
 	}
 
 };
@@ -733,19 +753,12 @@ bool Body<MarkerType>::isInVoxel(double x, double y, double z, int curr_mark) {
 template <typename MarkerType>
 bool Body<MarkerType>::isVoxelMarkerVoxel(double x, double y, double z) {
 
-	// Try get the MarkerData store
-	MarkerData* m_data = getMarkerData(x, y, z);
-
-	// True if the data store is not empty
-	if (m_data->isValid()) {
-
-		delete m_data;	// Deallocate the store before leaving scope
-		return true;
-
-	}
+	// Get indices of voxel associated with the supplied position
+	std::vector<int> vox;
+	if (!GridUtils::isOnThisRank(x, y, z, nullptr, _Owner, &vox)) return false;
 
-	delete m_data;
-	return false;
+	// True if a marker has this as its primary support voxel
+	return (markerIndex.find(vox[0], vox[1], vox[2]) != nullptr);
 
 };
 
@@ -765,9 +778,14 @@ void Body<MarkerType>::buildFromCloud(PCpts *_PCpts)
 
 	*GridUtils::logfile << "ObjectManager: Applying voxel grid filter..." << std::endl;
 
+	// Markers are indexed by their primary support voxel while filtering
+	markerIndex.reset(_Owner->dh);
+
 	// Place first marker
-	if (!_PCpts->x.empty())
+	if (!_PCpts->x.empty()) {
 		addMarker(_PCpts->x[0], _PCpts->y[0], _PCpts->z[0], _PCpts->id[0]);
+		markerIndex.insert(markers[0].supp_i[0], markers[0].supp_j[0], markers[0].supp_k[0], 0);
+	}
 
 	// Increment counters
 	int curr_marker = 0;
@@ -780,6 +798,7 @@ void Body<MarkerType>::buildFromCloud(PCpts *_PCpts)
 		// Pass to point builder
 		passToVoxelFilter(_PCpts->x[a], _PCpts->y[a], _PCpts->z[a], _PCpts->id[a], curr_marker, counter);
 	}
+	markerIndex.reset(_Owner->dh);
 
 	*GridUtils::logfile << "ObjectManager: Object represented by " << std::to_string(markers.size()) <<
 		" markers using 1 marker / voxel voxelisation." << std::endl;
@@ -179,4 +179,12 @@ enum eSDReturnType {
 	eSDEarlyExit
 };
 
+///	\enum eSupportChange
+///	\brief	Extent of the change to the IBM support sites after the markers move.
+enum eSupportChange {
+	eSupportUnchanged,	///< No support site has changed
+	eSupportMoved,		///< Some support sites have moved but are owned by the same ranks
+	eSupportCrossed		///< The owning ranks of some support sites have changed
+};
+
 #endif
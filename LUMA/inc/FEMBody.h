@@ -101,6 +101,13 @@ class FEMBody {
 	std::vector<double> Udotdot;				///< Vector of accelerations
 	std::vector<double> Udotdot_n;				///< Vector of accelerations at start of current time step
 
+	// FSI coupling
+	double relaxOmega;									///< Relaxation factor used in the last sub-iteration (Aitken)
+	std::vector<double> couplingRes;					///< Interface residual of the last sub-iteration
+	std::vector<double> couplingTilde;					///< Marker velocities from the FEM solve of the last sub-iteration
+	std::vector<std::vector<double>> couplingV;			///< Differences between successive interface residuals this time step (IQN-ILS)
+	std::vector<std::vector<double>> couplingW;			///< Differences between successive FEM marker velocities this time step (IQN-ILS)
+
 	// Vector of parent elements for each IBM node
 	std::vector<IBMParentElements> IBNodeParents;
 
@@ -114,6 +121,8 @@ class FEMBody {
 	void finishNewmark();										// Newmark-Beta scheme for getting FEM velocities and accelerations
 	void updateFEMValues();										// Update the FEM node data using the new displacements
 	void updateIBMarkers();										// Update the IBM markers using new FEM node vales
+	void relaxMarkerVels(std::vector<double> &velTilde);		// Set the next FSI iterate of the marker velocities
+	void resetCoupling();										// Clear the FSI coupling history at the end of a time step
 
 	// Helper methods
 	double checkNRConvergence();								// Check convergence of the Newton-Raphson scheme
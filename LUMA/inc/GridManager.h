@@ -113,6 +113,8 @@ private:
 	void updateGlobalCellCount();
 	long getActiveCellCount(double *bounds, bool bCountAsOps);
 	long getCellCount(int targetLevel, int targetRegion, double *bounds);
+	long getCellCount(int targetLevel, double *box, double *bounds);
+	double getActiveCellCost(double *bounds);
 
 
 private:
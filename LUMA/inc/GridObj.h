@@ -81,7 +81,6 @@ private :
 	IVector<double> feq;			///< Equilibrium distribution functions
 	IVector<double> fNew;			///< Copy of distribution functions
 	IVector<double> u;				///< Macropscopic velocity components
-	IVector<double> u_n;			///< Macropscopic velocity components at start of current time step
 	IVector<double> force_xyz;		///< Macroscopic body force components
 	IVector<double> force_i;		///< Mesoscopic body force components
 
@@ -155,6 +154,8 @@ public :
 	void io_fgaout();							// Wrapper for _io_fgaout with 2/3D checking 
 	void io_restart(eIOFlag IO_flag);			// Reads/writes data from/to the global restart file
 	void io_probeOutput();						// Output routine for point probes
+	void io_probeFlush();						// Write out any probe values still being gathered
+	void io_probeWrite(std::vector<double>& values, int tval);	// Write a set of probe values to file
 	void io_lite(double tval, std::string Tag);	// Generic writer to individual files with Tag
 	int io_hdf5(double tval);					// HDF5 writer returning integer to indicate success or failure
 
@@ -179,6 +180,7 @@ private :
 	void _LBM_regularised_opt(int i, int j, int k, int id, eType type, int subcycle);
 	void _LBM_kbcCollide_opt(int id);
 	void _LBM_resetForces();
+	void _LBM_resetForces(int id);
 	double _LBM_smag(int id, double omega);
 	void _LBM_updateInteriorLatticeSite(int i, int j, int k, int subcycle);
 	double _LBM_updateAndExtrapolate(int subcycle, IVector<double> &quantity,
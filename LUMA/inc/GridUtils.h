@@ -77,6 +77,9 @@ public:
 	static std::vector<double> divide(std::vector<double> vec1, double scalar);					// Divide vector by a scalar
 	static std::vector<std::vector<double>> matrix_transpose(std::vector<std::vector<double>> &origMat);			// Transpose a matrix
 	static std::vector<double> solveLinearSystem(std::vector<std::vector<double>> &A, std::vector<double> b, int BC = 0);		// Solve A.x = b
+	static std::vector<double> solveSparseLinearSystem(const std::vector<int> &rowStart, const std::vector<int> &cols, 
+		const std::vector<double> &vals, const std::vector<double> &b, const std::vector<double> &x0 = std::vector<double>(), 
+		double tol = 1e-10);																								// Solve sparse A.x = b iteratively
 
 	// LBM-specific utilities
 	static int getOpposite(int direction);	// Function: getOpposite
@@ -103,7 +106,6 @@ public:
 	static bool isOnRecvLayer(double pos_x, double pos_y, double pos_z);			// Is site on any recv layer
 	static bool isOnSenderLayer(double site_position, eCartMinMax edge);			// Is site on specified sender layer
 	static bool isOnRecvLayer(double site_position, eCartMinMax edge);				// Is site on specified recv layer
-	static int getMpiDirection(int offset_vector[]);								// Get MPI direction from vector
 	static int safeGetRank();														// Parallel/Serial safe method to get rank
 
 	// Coordinate Management
@@ -63,6 +63,7 @@ protected:
 
 	// Support quantities
 	std::vector<double> deltaval;		///< Value of delta function for a given support node
+	std::vector<int> supportCage;		///< Enclosing voxel and extent of the support along each axis when the support was last found
 
 	// Scalars
 	double epsilon;			///< Scaling parameter
@@ -0,0 +1,153 @@
+/*
+* --------------------------------------------------------------
+*
+* ------ Lattice Boltzmann @ The University of Manchester ------
+*
+* -------------------------- L-U-M-A ---------------------------
+*
+* Copyright 2018 The University of Manchester
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.*
+*/
+
+#ifndef MARKERINDEX_H
+#define MARKERINDEX_H
+
+#include "stdafx.h"
+#include <unordered_map>
+
+/// \brief	Uniform cell list over the markers of a body.
+///
+///			Markers are binned into cubic cells so that neighbour queries 
+///			only visit the cells around the query rather than every marker 
+///			of the body. Cells are addressed by integer indices so the list 
+///			may equally be keyed by lattice voxel.
+class MarkerIndex {
+
+public:
+
+	/// Default Constructor
+	MarkerIndex(void)
+		: width(1.0)
+	{ };
+
+	/// Default destructor
+	~MarkerIndex(void) {};
+
+	/// \brief	Empty the list and set the width of its cells.
+	/// \param	cellWidth	width of the cells in physical units.
+	void reset(double cellWidth)
+	{
+		width = cellWidth;
+		cells.clear();
+	}
+
+	/// \brief	Add a marker to the cell with the given indices.
+	/// \param	i	i-index of the cell
+	/// \param	j	j-index of the cell
+	/// \param	k	k-index of the cell
+	/// \param	id	index of the marker in the body
+	void insert(int i, int j, int k, int id)
+	{
+		cells[key(i, j, k)].push_back(id);
+	}
+
+	/// \brief	Add a marker to the cell containing its position.
+	/// \param	pos	position of the marker
+	/// \param	id	index of the marker in the body
+	void insert(const std::vector<double>& pos, int id)
+	{
+		insert(cellOf(pos[eXDirection]), cellOf(pos[eYDirection]), cellOf(pos[eZDirection]), id);
+	}
+
+	/// \brief	Markers in the cell with the given indices.
+	/// \param	i	i-index of the cell
+	/// \param	j	j-index of the cell
+	/// \param	k	k-index of the cell
+	/// \returns	markers in order of insertion or nullptr if the cell is empty
+	const std::vector<int>* find(int i, int j, int k) const
+	{
+		auto cell = cells.find(key(i, j, k));
+		return (cell == cells.end() ? nullptr : &cell->second);
+	}
+
+	/// \brief	Find the markers in the cells overlapping a box.
+	///
+	///			Every marker inside the box is found but markers outside it 
+	///			sharing a cell with the box are found too.
+	///
+	/// \param	lo		lower corner of the box
+	/// \param	hi		upper corner of the box
+	/// \param	found	markers found are appended to this list
+	void findInBox(const double lo[3], const double hi[3], std::vector<int>& found) const
+	{
+		for (int i = cellOf(lo[eXDirection]); i <= cellOf(hi[eXDirection]); i++)
+		for (int j = cellOf(lo[eYDirection]); j <= cellOf(hi[eYDirection]); j++)
+		for (int k = cellOf(lo[eZDirection]); k <= cellOf(hi[eZDirection]); k++)
+		{
+			const std::vector<int> *cell = find(i, j, k);
+			if (cell) found.insert(found.end(), cell->begin(), cell->end());
+		}
+	}
+
+	/// \brief	Find the markers in the shell of cells around a position.
+	///
+	///			The shell holds the cells exactly r cells away from the cell 
+	///			containing the position in any direction. Searching shells of
+	///			increasing r visits the markers roughly in order of distance: 
+	///			those not yet visited after shell r are more than r cell widths 
+	///			away.
+	///
+	/// \param	pos		position at the centre of the shell
+	/// \param	r		shell number (0 is the cell containing the position)
+	/// \param	found	markers found are appended to this list
+	void findInShell(const std::vector<double>& pos, int r, std::vector<int>& found) const
+	{
+		int ci = cellOf(pos[eXDirection]), cj = cellOf(pos[eYDirection]), ck = cellOf(pos[eZDirection]);
+#if (L_DIMS == 3)
+		int rk = r;
+#else
+		int rk = 0;
+#endif
+		for (int i = -r; i <= r; i++)
+		for (int j = -r; j <= r; j++)
+		for (int k = -rk; k <= rk; k++)
+		{
+			// Only the outside of the block
+			if (std::abs(i) != r && std::abs(j) != r && std::abs(k) != r) continue;
+			const std::vector<int> *cell = find(ci + i, cj + j, ck + k);
+			if (cell) found.insert(found.end(), cell->begin(), cell->end());
+		}
+	}
+
+private:
+
+	/// Index of the cell containing a coordinate
+	int cellOf(double x) const
+	{
+		return static_cast<int>(std::floor(x / width));
+	}
+
+	/// Pack the cell indices into a single key (21 bits each)
+	static long long key(int i, int j, int k)
+	{
+		const long long offset = 1 << 20;
+		return ((i + offset) << 42) | ((j + offset) << 21) | (k + offset);
+	}
+
+	double width;										///< Width of the cells
+	std::unordered_map<long long, std::vector<int>> cells;	///< Markers in each occupied cell
+
+};
+
+#endif // MARKERINDEX_H
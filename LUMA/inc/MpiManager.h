@@ -31,14 +31,6 @@ class GridManager;
 class IBBody;
 
 
-// Define the loop expressions required to inspect the overlap regions of a grid for ease of coding
-#define range_i_left	i = 0; i < GridUtils::downToLimit((int)pow(2, g->level + 1), N_lim); i++	///< For loop definition for left halo
-#define range_j_down	j = 0; j < GridUtils::downToLimit((int)pow(2, g->level + 1), M_lim); j++	///< For loop definition for bottom halo
-#define range_k_front	k = 0; k < GridUtils::downToLimit((int)pow(2, g->level + 1), K_lim); k++	///< For loop definition for front halo
-#define range_i_right	i = GridUtils::upToZero(N_lim - (int)pow(2, g->level + 1)); i < N_lim; i++	///< For loop definition for right halo
-#define range_j_up		j = GridUtils::upToZero(M_lim - (int)pow(2, g->level + 1)); j < M_lim; j++	///< For loop definition for top halo
-#define range_k_back	k = GridUtils::upToZero(K_lim - (int)pow(2, g->level + 1)); k < K_lim; k++	///< For loop definition for back halo
-
 /// \brief	MPI Manager class.
 ///
 ///			Class to manage all MPI apsects of the code.
@@ -103,17 +95,23 @@ public :
 	// MPI world data (all public)
 	MPI_Comm world_comm;	///< Global MPI communicator
 
-	/// \brief	Cartesian unit vectors pointing to each neighbour in Cartesian topology.
+	int dimensions[3];							///< Size of MPI Cartesian topology (chosen at runtime if not fixed in the definitions)
+	std::string topology_error;					///< Reason the requested topology could not be built (reported once the logfile is open)
+
+	/// \brief	Ranks which exchange halo data with this rank.
 	///
-	///			Define 3D such that first 8 mimic the 2D ones. Opposites are 
-	///			simply the next or previous column in the array. MSVC 2013 does
-	///			not support initialiser lists tagged onto the constructor although
-	///			it is valid C++ so I have had to make it static even though it goes
-	///			against the idea of the singleton design.
-	static const int neighbour_vectors[3][26];
-	int dimensions[3];							///< Size of MPI Cartesian topology
-	int neighbour_rank[L_MPI_DIRS];				///< Neighbour rank number for each direction in Cartesian topology
-	int neighbour_coords[L_DIMS][L_MPI_DIRS];	///< Coordinates in MPI topology of neighbour ranks
+	///			Any rank whose core overlaps the halo of this rank or whose halo 
+	///			overlaps the core of this rank, accounting for periodicity. The 
+	///			list is built from the block edges so does not assume a Cartesian
+	///			arrangement of the blocks.
+	std::vector<int> neighbour_rank;
+
+	/// \brief	Exchange stage in which each neighbour is serviced.
+	///
+	///			All neighbours share stage 0 unless face exchanges are enabled.
+	///			Then a face neighbour is serviced in the stage of the direction 
+	///			separating it from this rank and the rest take no part (-1).
+	std::vector<int> neighbour_stage;
 
 	// Sizes of each of the MPI domains
 	/// Number of sites in X direction for each custom rank.
@@ -137,6 +135,7 @@ public :
 	int my_rank;				///< Rank number
 	int num_ranks;				///< Total number of ranks in MPI Cartesian topology
 	int rank_coords[L_DIMS];	///< Coordinates in MPI Cartesian topology
+	std::vector<int> rank_node;	///< Index of the shared-memory node holding each rank
 
 
 	/// \brief	Absolute positions of edges of the core region represented on this rank.
@@ -163,28 +162,49 @@ public :
 	};
 	HaloEdgeStruct sender_layer_pos;	///< Structure containing sender layer edge positions.
 	HaloEdgeStruct recv_layer_pos;		///< Structure containing receiver layer edge positions.
+	std::vector<int> halo_exchange_interval;	///< Time steps taken between halo exchanges on each level
+	std::vector<int> halo_exchange_depth;		///< Layers of the halo (in cells of each level) sent at each exchange
+	std::vector<bool> halo_single_precision;	///< Whether each level sends its halo populations in single precision
 	
 
 	// Buffer data
-	std::vector< std::vector<double>> f_buffer_send;	///< Array of resizeable outgoing buffers used for data transfer
-	std::vector< std::vector<double>> f_buffer_recv;	///< Array of resizeable incoming buffers used for data transfer
-	MPI_Status recv_stat;					///< Status structure for Receive return information
-	MPI_Request send_requests[L_MPI_DIRS];	///< Array of request structures for handles to posted ISends
-	MPI_Status send_stat[L_MPI_DIRS];		///< Array of statuses for each ISend
-
-	/// \struct BufferSizeStruct
-	/// \brief	Structure storing buffers sizes in each direction for particular grid.
-	struct BufferSizeStruct
+	std::vector< std::vector<double>> f_buffer_send;	///< Array of resizeable outgoing buffers used for data transfer (one per neighbour)
+	std::vector< std::vector<double>> f_buffer_recv;	///< Array of resizeable incoming buffers used for data transfer (one per neighbour)
+	MPI_Status recv_stat;						///< Status structure for Receive return information
+	std::vector<MPI_Request> send_requests;		///< Array of request structures for handles to posted ISends
+	std::vector<MPI_Status> send_stat;			///< Array of statuses for each ISend
+
+	/// \struct BufferSiteStruct
+	/// \brief	Structure storing the sites exchanged with each neighbour for particular grid.
+	///
+	///			Sites are stored as flattened local indices in the order in 
+	///			which they appear in the buffer. The receiver decides the order 
+	///			and the sender follows it.
+	struct BufferSiteStruct
 	{
-		int size[L_MPI_DIRS];	///< Buffer sizes for each direction
-		int level;				///< Grid level
-		int region;				///< Region number
+		std::vector< std::vector<int> > sites;	///< Local site indices for each neighbour
+		int level;								///< Grid level
+		int region;								///< Region number
 
-		BufferSizeStruct(int l, int r) 
-			: level(l), region(r){};
+		BufferSiteStruct(int l, int r, size_t numNeighbours) 
+			: sites(numNeighbours), level(l), region(r){};
+	};
+	std::vector<BufferSiteStruct> buffer_send_info;	///< Vectors of buffer_info structures holding sender layer sites.
+	std::vector<BufferSiteStruct> buffer_recv_info;	///< Vectors of buffer_info structures holding receiver layer sites.
+
+	/// \struct ExchangeGridStruct
+	/// \brief	Structure describing a grid whose halo exchange is queued.
+	///
+	///			Exchanges queued together are sent as one message per neighbour 
+	///			with the sites of each grid starting at its offset.
+	struct ExchangeGridStruct
+	{
+		GridObj *grid;						///< Grid to exchange
+		size_t info;						///< Index of the site lists of the grid
+		std::vector<size_t> send_offset;	///< Offset (in buffer words) of the grid in the outgoing buffer for each neighbour
+		std::vector<size_t> recv_offset;	///< Offset (in buffer words) of the grid in the incoming buffer for each neighbour
 	};
-	std::vector<BufferSizeStruct> buffer_send_info;	///< Vectors of buffer_info structures holding sender layer size info.
-	std::vector<BufferSizeStruct> buffer_recv_info;	///< Vectors of buffer_info structures holding receiver layer size info.
+	std::vector<ExchangeGridStruct> exchange_queue;	///< Grids whose halo exchange is held back until their parent exchanges
 
 	/// Logfile handle
 	std::ofstream* logout;
@@ -195,6 +215,58 @@ public :
 	std::vector<std::vector<SupportCommMarkerSideClass>> supportCommMarkerSide;		///< Marker-side marker-support comm
 	std::vector<std::vector<SupportCommSupportSideClass>> supportCommSupportSide;	///< Support-side marker-support comm
 
+	/// \brief	Cached layout of an IBM comm class.
+	///
+	///			Groups the entries of a comm class by the rank they exchange 
+	///			data with so that each rank is sent a single packed message.
+	///			Offsets are in units of entries and are scaled by the number 
+	///			of values per entry when a message is packed.
+	struct IBCommLayoutStruct
+	{
+		std::vector<int> ranks;		///< Ranks exchanged with in ascending order
+		std::vector<int> offset;	///< Offset of the block of each rank (one extra entry at the end)
+		std::vector<int> slot;		///< Offset of each comm entry within its block
+	};
+
+	/// \brief	Cached IBM comm layouts and buffers of a grid level.
+	///
+	///			Built with the comm classes and reused every time step until 
+	///			the support topology changes and the classes are rebuilt.
+	struct IBCommPlanStruct
+	{
+		IBCommLayoutStruct supportSide;			///< Layout of supportCommSupportSide
+		IBCommLayoutStruct supportMarkerSide;	///< Layout of supportCommMarkerSide
+		IBCommLayoutStruct ownerSide;			///< Layout of markerCommOwnerSide
+		IBCommLayoutStruct markerSide;			///< Layout of markerCommMarkerSide
+		IBCommLayoutStruct ownerSideSupports;	///< Layout of markerCommOwnerSide sized by the support data of each marker
+		IBCommLayoutStruct markerSideSupports;	///< Layout of markerCommMarkerSide sized by the support data of each marker
+		std::vector<double> sendBuffer;			///< Packed outgoing values
+		std::vector<double> recvBuffer;			///< Packed incoming values
+		std::vector<MPI_Request> requests;		///< Handles to the messages in flight
+	};
+	std::vector<IBCommPlanStruct> ibm_comm_plan;	///< IBM comm layouts and buffers of each level
+
+	// Dynamic load balancing data
+	double balance_compute_time;								///< Compute time accumulated on this rank since the last balance check
+	std::vector<double> balance_rank_weights;					///< Measured cost per operation of each rank used to weight the decomposition
+	std::vector< std::vector<double> > balance_weight_edges;	///< Rank core edges at the time the weights were measured
+
+	// Non-blocking diagnostics data
+	MPI_Request probe_request;									///< Handle to the pending reduction of probe values
+	std::vector<double> probe_send_buffer;						///< Probe values from this rank being reduced
+	std::vector<double> probe_recv_buffer;						///< Reduced probe values on the master rank
+	int probe_time;												///< Time step of the pending probe values
+	double step_compute_time;									///< Compute time accumulated on this rank since the last wait report
+	int step_count;												///< Number of time steps since the last wait report
+	double wait_report_send;									///< Compute time of this rank being reduced for the wait report
+	double wait_report_recv[2];									///< Maximum and total compute time over all ranks
+	int wait_report_steps;										///< Number of time steps covered by the pending wait report
+	MPI_Request wait_report_requests[2];						///< Handles to the pending reductions of the wait report
+	double diagnostics_wait_time;								///< Time spent waiting for non-blocking diagnostics to complete
+
+	// Smart decomposition data
+	std::vector<double> sd_cost_table;							///< Prefix-sum table of coarse cell costs
+	int sd_table_size[3];										///< Size of the prefix-sum table in each direction
 
 
 	/************** Member Methods **************/
@@ -205,11 +277,15 @@ public :
 
 	// Initialisation
 	void mpi_init();												// Initialisation of MpiManager & Cartesian topology
+	void mpi_setTopology(MPI_Comm base_comm, int reorder);			// Create the Cartesian communicator from the current dimensions
+	void mpi_setNeighbours();										// Build the list of ranks which share halo data with this rank
+	bool mpi_hasHalo(int dir, int rank);							// Does the block of a rank have a halo in a direction
 	void mpi_gridbuild(GridManager* const grid_man);				// Do domain decomposition to build local grid dimensions
 	void mpi_communicateBlockEdges();								// Get the positional limits of all ranks
 	int mpi_buildCommunicators(GridManager* const grid_man);		// Create a new communicator for each sub-grid and region combo
 	void mpi_updateLoadInfo(GridManager* const grid_man);			// Method to compute the number of active cells on the rank and pass to master
 	void mpi_uniformDecompose(int *numCells);						// Method to perform uniform decomposition into MPI blocks
+	double mpi_rcbDecompose(double dh);								// Method to perform recursive bisection into non-Cartesian blocks
 	LoadImbalanceData mpi_smartDecompose(double dh,
 		std::vector<int> combo = std::vector<int>(0));				// Method to perform load-balanced decomposition into MPI blocks
 	void mpi_reportOnDecomposition(double dh);						// Method to provide a report on decomposition options
@@ -218,35 +294,76 @@ public :
 	bool mpi_SDCheckDelta(SDData& solutionData, double dh, std::vector<int>& numCores);
 	void mpi_SDCommunicateSolution(SDData& solutionData, double imbalance, double dh);
 	void mpi_setSubGridDepth();										// Method to initialise the rankGrids variable
+	void mpi_setBlockGeometry(GridManager* const grid_man);			// Set local sizes, core edges and halo positions from the rank sizes
+	bool mpi_placeRanksOnNodes(GridManager* const grid_man);		// Renumber the ranks so each node holds a compact sub-block of the topology
+	void mpi_renameLogs(int oldRank);								// Rename the logs of this rank after the ranks are renumbered
+	double mpi_SDBlockCost(double *bounds);							// Cost of a candidate block used by the smart decomposition
+	void mpi_SDBuildCostTable(double dh);							// Build the prefix-sum table of coarse cell costs
+	double mpi_SDTableCost(double *bounds);							// Cost of a block from the prefix-sum table
+	double mpi_SDTableCost(int *lo, int *hi);						// Cost of a block of coarse cells from the prefix-sum table
+	void mpi_SDExactPartition(SDData& solutionData,
+		std::vector<int>& numCores, double dh);						// Optimise block edges one direction at a time
+	/// Index into the prefix-sum table
+	inline size_t mpi_SDTableIndex(int i, int j, int k)
+	{
+		return static_cast<size_t>(k) + static_cast<size_t>(sd_table_size[eZDirection]) *
+			(static_cast<size_t>(j) + static_cast<size_t>(sd_table_size[eYDirection]) * i);
+	}
+	void mpi_SDSelectDims(double dh);								// Choose free topology directions using the smart decomposition cost
+	double mpi_predictImbalance();									// Imbalance expected from the current block edges
 
 	// Helper functions
 	std::vector<int> mpi_mapRankLevelToWorld(int level);			// Map rank numbers from level communicator to world communcator
 	std::vector<int> mpi_mapRankWorldToLevel(int level);			// Map rank numbers from world communicator to level communicator
+	void mpi_sparseExchange(MPI_Comm comm, int tag,
+		const std::vector<int> &toRanks, const std::vector<std::vector<double>> &sendBuffers,
+		std::vector<int> &fromRanks, std::vector<std::vector<double>> &recvBuffers);	// Exchange messages with an irregular set of ranks
 
 	// Buffer methods
-	void mpi_buffer_pack(int dir, GridObj* const g);		// Pack the buffer ready for data transfer on the supplied grid in specified direction
-	void mpi_buffer_unpack(int dir, GridObj* const g);		// Unpack the buffer back to the grid given
-	void mpi_buffer_size();									// Set buffer size information for grids in hierarchy given and 
-															// set pointer to hierarchy for subsequent access
-	void mpi_buffer_size_send( GridObj* const g );			// Routine to find the size of the sending buffer on supplied grid
-	void mpi_buffer_size_recv( GridObj* const g );			// Routine to find the size of the receiving buffer on supplied grid
+	void mpi_buffer_pack(int nbr, GridObj* const g, size_t offset);		// Pack the buffer ready for data transfer on the supplied grid to specified neighbour
+	void mpi_buffer_unpack(int nbr, GridObj* const g, size_t offset);	// Unpack the buffer back to the grid given
+	void mpi_buffer_size();									// Set buffer site information for grids in hierarchy given
+	size_t mpi_bufferWords(int level, size_t sites);		// Number of buffer words taken by the halo sites of a level
+	void mpi_buffer_size_send(GridObj* const g,
+		std::vector< std::vector<int> >& requests);			// Routine to find the sites of the sending buffer on supplied grid
+	void mpi_buffer_size_recv(GridObj* const g,
+		std::vector< std::vector<int> >& requests);			// Routine to find the sites of the receiving buffer on supplied grid
+	void mpi_setExchangeIntervals();						// Decide how many steps each level takes between halo exchanges and how much halo is sent
+	void mpi_reportNodeTraffic();							// Report the halo data sent within and between nodes
+
+	// Dynamic load balancing
+	bool mpi_dynamicBalance(GridManager* const grid_man);			// Re-decompose the domain if the measured load is imbalanced
+	bool mpi_overlapsLocalBlock(double lo, double hi, int dir, int rank);	// Does a range of positions reach the local grid (inc. halo) of the given rank
+	void mpi_migrateGridData(GridObj* const oldGrids, GridObj* const newGrids,
+		std::vector< std::vector<double> >& oldEdges);				// Move lattice data from the old to the new decomposition
+	std::vector<int> mpi_migrateMarkers(
+		std::vector< std::vector<double> >& oldEdges);				// Move IB markers onto the ranks of the new decomposition
 
 	// IO
-	void mpi_writeout_buf(std::string filename, int dir);		// Write out the buffers of direction dir to file
+	void mpi_writeout_buf(std::string filename, int nbr);		// Write out the buffers of neighbour nbr to file
 
 	// Comms
-	void mpi_communicate( int level, int regnum );		// Wrapper routine for communication between grids of given level/region
-	int mpi_getOpposite(int direction);					// Version of GridUtils::getOpposite for MPI_directions rather than lattice directions
+	void mpi_communicate( int level, int regnum, int subcycle );	// Wrapper routine for communication between grids of given level/region
+
+	// Non-blocking diagnostics
+	void mpi_reportWaitSaved();							// Report the wait avoided by not synchronising every time step
+	void mpi_completeWaitReport();						// Complete and log any outstanding wait report
 
 	// IBM
 	void mpi_buildMarkerComms(int level);												// Build comms required for epsilon calculation
 	void mpi_buildSupportComms(int level);												// Build comms required for support communication
+	void mpi_refreshSupportComms(int level, const std::vector<std::vector<bool>> &moved);	// Update the support comms of markers whose off-rank sites moved
 	void mpi_epsilonCommGather(int level);												// Do communication required for epsilon calculation
 	void mpi_epsilonCommScatter(int level);												// Do communication required for epsilon calculation
 	void mpi_uniEpsilonCommGather(int level, int rootRank, IBBody &iBodyTmp);			// Do communication required for universal epsilon calculation
 	void mpi_uniEpsilonCommScatter(int level, int rootRank, IBBody &iBodyTmp);			// Do communication required for universal epsilon calculation
-	void mpi_interpolateComm(int level, std::vector<std::vector<double>> &interpVels);	// Do communication required for velocity interpolation
-	void mpi_spreadComm(int level, std::vector<std::vector<double>> &spreadForces);		// Do communication required for force spreading
+	void mpi_interpolateCommStart(int level);											// Start communication required for velocity interpolation
+	void mpi_spreadCommStart(int level);												// Start communication required for force spreading
+	void mpi_buildIBMCommLayout(IBCommLayoutStruct &layout,
+		const std::vector<int> &ranks, const std::vector<int> &sizes);					// Group the entries of a comm class into one block per rank
+	void mpi_startIBMComm(int level, const IBCommLayoutStruct &sendLayout,
+		const IBCommLayoutStruct &recvLayout, int width);								// Post the packed IBM messages of a level
+	void mpi_finishIBMComm(int level);													// Wait for the packed IBM messages of a level
 	void mpi_dsCommScatter(int level);													// Spread the ds values from owner to other ranks
 	void mpi_ptCloudMarkerGather(IBBody *iBody, std::vector<double> &recvPositionBuffer, std::vector<int> &recvIDBuffer, std::vector<int> &recvSizeBuffer, std::vector<int> &recvDisps);		// Gather in info for pt cloud sorter
 	void mpi_ptCloudMarkerScatter(IBBody *iBody, std::vector<int> &recvIDBuffer, std::vector<int> &recvSizeBuffer, std::vector<int> &recvDisps);	// Scatter info for pt cloud sorter
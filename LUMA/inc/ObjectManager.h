@@ -86,6 +86,46 @@ class ObjectManager
 
 	};
 
+	/// \brief	Support stencils of the IB markers on a level in flat arrays.
+	///
+	///			Built from the marker data whenever the supports change so that
+	///			the interpolate, spread and update loops stream through 
+	///			contiguous memory. Each marker has a stencil of fixed capacity
+	///			holding the flat grid indices and delta values of its support 
+	///			sites on this rank. Markers are also grouped into colours such
+	///			that no two markers of the same colour share a support site, 
+	///			which lets each colour be spread by several threads at once.
+	///			The distinct support sites on this rank, including those of 
+	///			off-rank markers, are also listed once each for the 
+	///			macroscopic update.
+	struct IBSupportPack
+	{
+		int stride = 0;						///< Capacity of each marker's stencil
+		std::vector<int> body;				///< Body index of each marker
+		std::vector<int> marker;			///< Index of each marker within its body
+		std::vector<int> count;				///< Number of on-rank support sites of each marker
+		std::vector<int> site;				///< Flat grid index of each support site
+		std::vector<double> delta;			///< Delta value at each support site
+		std::vector<int> colourStart;		///< Offset of each colour in colourMarkers (one extra entry at the end)
+		std::vector<int> colourMarkers;		///< Packed marker indices grouped by colour
+		std::vector<int> uniqueSite;		///< Flat grid index of each distinct support site this rank owns
+		std::vector<int> uniqueBody;		///< Index of a body whose grid holds each distinct support site
+	};
+
+	/// \brief	Start-of-step state of the sites touched by flexible bodies.
+	///
+	///			Holds the velocity of every site that has been in the support 
+	///			of a marker since the start of the current time step so that
+	///			the sub-iterations only need to restore these sites rather 
+	///			than the whole grid.
+	struct IBSubIterState
+	{
+		int step = 0;						///< Counter identifying the current time step
+		std::vector<int> savedAt;			///< Step at which each grid site was last saved
+		std::vector<int> sites;				///< Flat grid index of each saved site
+		std::vector<double> u;				///< Saved velocity components of each saved site
+	};
+
 	/* Members */
 
 private:
@@ -114,6 +154,15 @@ private:
 	std::vector<bool> hasIBMBodies;
 	std::vector<bool> hasFlexibleBodies;
 
+	// Packed support stencils of the markers on each level
+	std::vector<IBSupportPack> ibmSupportPack;
+
+	// Start-of-step velocities of the support sites on each level
+	std::vector<IBSubIterState> ibmSubIterState;
+
+	// Flag for if ds and epsilon of all bodies on this rank were read from a matching restart file
+	bool ibmPrecomputeRestored;
+
 	// Map global body ID to an index in the iBody vector
 	std::vector<int> bodyIDToIdx;
 
@@ -141,12 +190,15 @@ public:
 	// IBM methods //
 	void ibm_apply(GridObj *g, bool doSubIterate);									// Apply interpolate, compute and spread operations for all bodies.
 	void ibm_initialise();															// Initialise a built immersed body with support.
+	void ibm_reinitialise(const std::vector<int> &changed);						// Rebuild the support of the given bodies after the domain is re-decomposed.
 	double ibm_deltaKernel(double rad, double dilation);							// Evaluate kernel (delta function approximation).
 	void ibm_interpolate(int level);												// Interpolation of velocity field onto markers of ib-th body.
 	void ibm_spread(int level);														// Spreading of restoring force from ib-th body.
+	void ibm_spreadMarker(IBSupportPack &pack, int p);								// Spread the force of one packed marker onto its support.
 	void ibm_updateMacroscopic(int level);											// Update the macroscopic values with the IBM force
-	void ibm_findSupport(int ib);													// Populates support information for the m-th marker of ib-th body.
-	void ibm_initialiseSupport(int ib, int m, std::vector<double> &estimated_position);	// Initialises data associated with the support points.
+	eSupportChange ibm_findSupport(int ib, std::vector<bool> *moved = nullptr);	// Populates support information for the m-th marker of ib-th body.
+	void ibm_initialiseSupport(int ib, int m, const double *weights);				// Initialises data associated with the support points.
+	void ibm_packSupport(int level, bool newSupport = true);						// Pack the support stencils of the markers on a level.
 	void ibm_computeForce(int level);												// Compute restorative force at each marker in ib-th body.
 	void ibm_findEpsilon(int level);												// Method to find epsilon weighting parameter for ib-th body.
 	void ibm_computeDs(int level);
@@ -156,6 +208,8 @@ public:
 	void ibm_universalEpsilonScatter(int level, IBBody &iBodyTmp);					// Gather all the markers into the temporary iBody vector
 	void ibm_subIterate(GridObj *g);												// Subiterate to enforce correct kinematic conditions at interface
 	double ibm_checkVelDiff(int level);												// Check residual from sub-iteration step
+	void ibm_saveSubIterSites(GridObj *g, bool newStep);							// Save start-of-step velocities of the current support sites
+	void ibm_restoreSubIterSites(GridObj *g);										// Restore velocities and reset forces at the saved support sites
 
 	// IBM Debug methods //
 	void ibm_debug_epsilon(int ib);
@@ -171,6 +225,7 @@ public:
 	void ibm_interpolateOffRankVels(int level);
 	void ibm_spreadOffRankForces(int level);
 	void ibm_updateMarkers(int level);
+	std::vector<int> ibm_markerLayout(int level);
 
 	// Bounceback Body Methods
 	void addBouncebackObject(GeomPacked *geom, PCpts *_PCpts);				// Override method to add BBB from cloud reader.
@@ -185,6 +240,7 @@ public:
 	void io_writeBodyPosition(int timestep);				// Write out IBBody positions at specified timestep to text files
 	void io_writeLiftDrag();								// Write out IBBody lift and drag at specified timestep
 	void io_restart(eIOFlag IO_flag, int level);			// Restart read and write for IBBodies given grid level
+	unsigned long long io_restartKey(int ib);				// Key identifying the geometry and grid that the IBM precomputation of a body depends on
 	void io_readInCloud(PCpts*& _PCpts, GeomPacked *geom);	// Method to read in Point Cloud data
 	void io_writeForcesOnObjects(double tval);				// Method to write object forces to a csv file
 	void io_readInGeomConfig();								// Read in geometry configuration file
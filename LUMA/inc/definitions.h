@@ -145,14 +145,30 @@
 *******************************************************************************
 */
 
-// MPI Data
+// MPI Data (set to 0 to choose the number of ranks in that direction at runtime)
 #define L_MPI_XCORES 2		///< Number of MPI ranks to divide domain into in X direction
 #define L_MPI_YCORES 2		///< Number of MPI ranks to divide domain into in Y direction
 #define L_MPI_ZCORES 2		///< Number of MPI ranks to divide domain into in Z direction.
 
 // Decomposition strategy
 //#define L_MPI_SMART_DECOMPOSE		///< Use smart decomposition to improve load balancing
+//#define L_MPI_RCB					///< Decompose into blocks by recursive bisection of the weighted cost rather than a Cartesian topology
+//#define L_MPI_NODE_AWARE			///< Number the ranks so that each shared-memory node holds a compact sub-block of the Cartesian topology
 #define L_MPI_SD_MAX_ITER 1000		///< Max number of iterations to be used for smart decomposition algorithm
+//#define L_MPI_SD_EXACT			///< Place block edges by exact 1D partitioning of each direction in turn rather than by perturbation
+//#define L_MPI_DYNAMIC_BALANCE		///< Periodically re-decompose the domain using the measured compute time on each rank
+#define L_MPI_BALANCE_FREQ 100		///< Number of time steps between load balance checks
+#define L_MPI_BALANCE_THRESHOLD 10.0	///< Measured load imbalance (%) above which the domain is re-decomposed
+
+// Decomposition cost weights (cost of a site relative to a fluid site)
+#define L_MPI_COST_SOLID 0.2		///< Solid site
+#define L_MPI_COST_TRANSITION 2.0	///< Site in a transition layer between grid levels
+#define L_MPI_COST_BFL 3.0			///< Site containing a BFL marker
+#define L_MPI_COST_IBM 1.0			///< Additional cost of each IB marker support site
+
+// Halo configuration
+#define L_MPI_HALO_DEPTH 1			///< Thickness of the halo in coarse cells (blocks must be at least this many cells wide)
+//#define L_MPI_FACE_EXCHANGE		///< Exchange halos with face neighbours only, in X then Y then Z, forwarding edge and corner sites (Cartesian decompositions only)
 
 // Topology report
 //#define L_MPI_TOPOLOGY_REPORT		///< Have the MPI Manager report on different combinations of X Y Z cores
@@ -222,7 +238,13 @@
 // FEM //
 #define L_NB_ALPHA 0.25				///< Parameter for Newmark-Beta time integration (0.25 for 2nd order)
 #define L_NB_DELTA 0.5				///< Parameter for Newmark-Beta time integration (0.5 for 2nd order)
-#define L_RELAX 0.5				///< Under-relaxation for FSI coupling
+#define L_RELAX 0.5				///< Under-relaxation for FSI coupling (first sub-iteration of each time step when accelerated)
+//#define L_FSI_AITKEN			///< Use Aitken dynamic relaxation for the FSI sub-iterations
+#define L_RELAX_MAX 1.0			///< Largest magnitude of the Aitken relaxation factor
+//#define L_FSI_IQN_ILS			///< Use interface quasi-Newton (IQN-ILS) acceleration for the FSI sub-iterations
+#define L_FSI_MAX_IT 10			///< Maximum number of FSI sub-iterations per time step
+#define L_FSI_TOL 1e-4			///< Tolerance on the normalised change in marker velocity for the FSI sub-iterations
+//#define L_WRITE_SUBITERATIONS		///< Write the number of FSI sub-iterations and final residual of every time step to the log file
 //#define L_WRITE_TIP_POSITIONS			///< Turn on writing out filament tip positions (only works on flexible filaments)
 
 /*
@@ -263,6 +285,12 @@
 #define L_NUM_REGIONS 1		///< Number of refined regions (can be arbitrary if L_NUM_LEVELS = 0)
 //#define L_AUTO_SUBGRIDS		///< Activate auto sub-grid generation using the padding parameters below
 
+// Per-level halo exchange (see the halo configuration of the MPI settings)
+/// Time steps taken on each level between halo exchanges (one entry per level, coarsest first). Level l may take up to L_MPI_HALO_DEPTH * 2^l steps; levels with IB bodies always exchange every step.
+static const int cMpiExchangeInterval[L_NUM_LEVELS + 1] = { 1, 1, 1, 1 };
+/// Levels whose halo is sent in single precision as deviations from the lattice weights (1 = on, one entry per level, coarsest first). Halves the message size at the cost of round-off in the received populations.
+static const int cMpiSinglePrecisionHalo[L_NUM_LEVELS + 1] = { 0, 0, 0, 0 };
+
 // Auto-sub-grid configuration (if you want coincident edges then set to (-2.0 * dh))
 #define L_PADDING_X_MIN (-2.0 * dh)		///< Padding between X start of each sub-grid and its child edge
 #define L_PADDING_X_MAX (2.0 * dh)		///< Padding between X end of each sub-grid and its child edge
@@ -323,14 +351,9 @@ const static double cProbeLimsZ[2] = { L_PROBE_MIN_Z, L_PROBE_MAX_Z };	///< Limi
 #define L_NUM_VELS 19		///< Number of lattice velocities
 #endif
 
-#define L_MPI_DIRS 26	///< Number of MPI directions
-
 #else
 #define L_NUM_VELS 9		// Use D2Q9
 
-// MPI config to 2D
-#define L_MPI_DIRS 8
-
 // Set Z limits for 2D
 #undef L_BZ
 #define L_BZ 0
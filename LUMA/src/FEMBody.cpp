@@ -38,6 +38,7 @@ FEMBody::FEMBody () {
 	timeav_FEMIterations = 0.0;
 	timeav_FEMResidual = 0.0;
 	BC_DOFs = 0;
+	relaxOmega = L_RELAX;
 }
 
 // *****************************************************************************
@@ -70,6 +71,7 @@ FEMBody::FEMBody (IBBody *iBody, std::vector<double> &start_position, double len
 	res = 0.0;
 	timeav_FEMIterations = 0.0;
 	timeav_FEMResidual = 0.0;
+	relaxOmega = L_RELAX;
 
 	// Set number of DOFs to remove in BC
 	if (clamped == true)
@@ -331,6 +333,7 @@ void FEMBody::updateIBMarkers() {
 	std::vector<double> dashU;
 	std::vector<double> dashUdot;
 	std::vector<std::vector<double>> T(L_DIMS, std::vector<double>(L_DIMS, 0.0));
+	std::vector<double> velTilde(IBNodeParents.size() * L_DIMS, 0.0);
 
 	// Loop through all IBM nodes
 	for (size_t node = 0; node < IBNodeParents.size(); node++) {
@@ -359,13 +362,156 @@ void FEMBody::updateIBMarkers() {
 		dashU = GridUtils::matrix_multiply(GridUtils::matrix_transpose(T), dashU);
 		dashUdot = GridUtils::vecmultiply(iBodyPtr->_Owner->dt / iBodyPtr->_Owner->dh, GridUtils::matrix_multiply(GridUtils::matrix_transpose(T), dashUdot));
 
-		// Set the IBM node
+		// Set the IBM node position and store the velocity from the FEM
 		for (int d = 0; d < L_DIMS; d++) {
 			iBodyPtr->markers[node].position[d] = iBodyPtr->markers[node].position0[d] + dashU[d];
-			iBodyPtr->markers[node].markerVel_km1[d] = iBodyPtr->markers[node].markerVel[d];
-			iBodyPtr->markers[node].markerVel[d] = L_RELAX * dashUdot[d] + (1.0 - L_RELAX) * iBodyPtr->markers[node].markerVel_km1[d];
+			velTilde[node * L_DIMS + d] = dashUdot[d];
 		}
 	}
+
+	// Set the new marker velocities
+	relaxMarkerVels(velTilde);
+}
+
+
+// *****************************************************************************
+///	\brief	Set the next FSI sub-iterate of the IBM marker velocities
+///
+///			Treats the marker velocities as the interface unknown of the 
+///			fixed-point FSI iteration. By default the velocities from the FEM 
+///			are under-relaxed with the constant L_RELAX. With L_FSI_AITKEN the
+///			relaxation factor is updated each sub-iteration by Aitken's delta^2
+///			method and limited to +-L_RELAX_MAX. With L_FSI_IQN_ILS the inverse Jacobian of the residual is
+///			approximated from the sub-iterations of this time step and used for
+///			a quasi-Newton update (Degroote et al. 2009). Both start each time 
+///			step with a step relaxed by L_RELAX.
+///
+///	\param	velTilde	marker velocities (lattice units) from the FEM solve
+void FEMBody::relaxMarkerVels(std::vector<double> &velTilde) {
+
+	// Current iterate and residual
+	size_t n = velTilde.size();
+	std::vector<double> vel(n), resid(n);
+	for (size_t node = 0; node < IBNodeParents.size(); node++) {
+		for (int d = 0; d < L_DIMS; d++) {
+			vel[node * L_DIMS + d] = iBodyPtr->markers[node].markerVel[d];
+			resid[node * L_DIMS + d] = velTilde[node * L_DIMS + d] - vel[node * L_DIMS + d];
+		}
+	}
+
+	// Next iterate
+	std::vector<double> velNew(n);
+
+#if defined L_FSI_IQN_ILS
+
+	// Add the differences from the last sub-iteration to the history
+	if (!couplingRes.empty()) {
+		couplingV.push_back(GridUtils::subtract(resid, couplingRes));
+		couplingW.push_back(GridUtils::subtract(velTilde, couplingTilde));
+	}
+	couplingRes = resid;
+	couplingTilde = velTilde;
+
+	// Relaxed step if there is no history yet
+	if (couplingV.empty()) {
+		for (size_t i = 0; i < n; i++)
+			velNew[i] = vel[i] + L_RELAX * resid[i];
+	}
+	else {
+
+		/* Least-squares solution of V.c = -r by a QR decomposition of V 
+		 * (modified Gram-Schmidt), newest columns first. Columns which are 
+		 * nearly linearly dependent on newer ones are dropped. */
+		std::vector<std::vector<double>> Q;
+		std::vector<std::vector<double>> Rcols;
+		std::vector<size_t> kept;
+		for (size_t j = couplingV.size(); j-- > 0;) {
+			std::vector<double> q = couplingV[j];
+			double norm0 = GridUtils::vecnorm(q);
+			std::vector<double> r(Q.size() + 1, 0.0);
+			for (size_t i = 0; i < Q.size(); i++) {
+				r[i] = GridUtils::dotprod(Q[i], q);
+				for (size_t k = 0; k < n; k++)
+					q[k] -= r[i] * Q[i][k];
+			}
+			r.back() = GridUtils::vecnorm(q);
+			if (r.back() <= 1e-10 * norm0) continue;
+			for (size_t k = 0; k < n; k++)
+				q[k] /= r.back();
+			Q.push_back(q);
+			Rcols.push_back(r);
+			kept.push_back(j);
+		}
+
+		// Back substitution of R.c = -Q^T.r (R stored by columns)
+		std::vector<double> c(Q.size(), 0.0);
+		for (size_t i = 0; i < Q.size(); i++)
+			c[i] = -GridUtils::dotprod(Q[i], resid);
+		for (size_t i = Q.size(); i-- > 0;) {
+			for (size_t j = i + 1; j < Q.size(); j++)
+				c[i] -= Rcols[j][i] * c[j];
+			c[i] /= Rcols[i][i];
+		}
+
+		// Quasi-Newton update
+		velNew = velTilde;
+		for (size_t i = 0; i < kept.size(); i++) {
+			for (size_t k = 0; k < n; k++)
+				velNew[k] += couplingW[kept[i]][k] * c[i];
+		}
+	}
+
+#elif defined L_FSI_AITKEN
+
+	// Update the relaxation factor from the change in residual
+	if (couplingRes.empty()) {
+		relaxOmega = L_RELAX;
+	}
+	else {
+
+		// Restart from L_RELAX if the residual has not changed
+		std::vector<double> delRes = GridUtils::subtract(resid, couplingRes);
+		double delResSq = GridUtils::dotprod(delRes, delRes);
+		if (delResSq <= 1e-12 * GridUtils::dotprod(resid, resid))
+			relaxOmega = L_RELAX;
+		else
+			relaxOmega = -relaxOmega * GridUtils::dotprod(couplingRes, delRes) / delResSq;
+
+		// Nearly parallel residuals give a huge factor so limit it
+		relaxOmega = std::max(-L_RELAX_MAX, std::min(relaxOmega, L_RELAX_MAX));
+	}
+	couplingRes = resid;
+
+	// Relaxed step
+	for (size_t i = 0; i < n; i++)
+		velNew[i] = vel[i] + relaxOmega * resid[i];
+
+#else
+
+	// Constant under-relaxation
+	for (size_t i = 0; i < n; i++)
+		velNew[i] = L_RELAX * velTilde[i] + (1.0 - L_RELAX) * vel[i];
+
+#endif
+
+	// Set the IBM nodes
+	for (size_t node = 0; node < IBNodeParents.size(); node++) {
+		for (int d = 0; d < L_DIMS; d++) {
+			iBodyPtr->markers[node].markerVel_km1[d] = vel[node * L_DIMS + d];
+			iBodyPtr->markers[node].markerVel[d] = velNew[node * L_DIMS + d];
+		}
+	}
+}
+
+
+// *****************************************************************************
+///	\brief	Clear the FSI coupling history at the end of a time step
+void FEMBody::resetCoupling() {
+
+	couplingRes.clear();
+	couplingTilde.clear();
+	couplingV.clear();
+	couplingW.clear();
 }
 
 
@@ -336,38 +336,38 @@ bool GridManager::createWritableDataStore(GridObj const * const targetGrid)
 		p_data->k_end = 0;
 
 #ifdef L_BUILD_FOR_MPI
-		// No transition layers on L0 and halo won't exist if MPI dimension is 1
-		if (MpiManager::getInstance()->dimensions[eXDirection] == 1)
+		// No transition layers on L0 and halo won't exist if block spans the domain
+		if (!MpiManager::getInstance()->mpi_hasHalo(eXDirection, MpiManager::getInstance()->my_rank))
 		{
 			p_data->i_end = N_lim - 1;
 			p_data->i_start = 0;
 		}
 		else
 		{
-			p_data->i_end = N_lim - 2;
-			p_data->i_start = 1;
+			p_data->i_end = N_lim - 1 - L_MPI_HALO_DEPTH;
+			p_data->i_start = L_MPI_HALO_DEPTH;
 		}
 
-		if (MpiManager::getInstance()->dimensions[eYDirection] == 1)
+		if (!MpiManager::getInstance()->mpi_hasHalo(eYDirection, MpiManager::getInstance()->my_rank))
 		{
 			p_data->j_end = M_lim - 1;
 			p_data->j_start = 0;
 		}
 		else
 		{
-			p_data->j_end = M_lim - 2;
-			p_data->j_start = 1;
+			p_data->j_end = M_lim - 1 - L_MPI_HALO_DEPTH;
+			p_data->j_start = L_MPI_HALO_DEPTH;
 		}
 #if (L_DIMS == 3)
-		if (MpiManager::getInstance()->dimensions[eZDirection] == 1)
+		if (!MpiManager::getInstance()->mpi_hasHalo(eZDirection, MpiManager::getInstance()->my_rank))
 		{
 			p_data->k_end = K_lim - 1;
 			p_data->k_start = 0;
 		}
 		else
 		{		
-			p_data->k_end = K_lim - 2;
-			p_data->k_start = 1;
+			p_data->k_end = K_lim - 1 - L_MPI_HALO_DEPTH;
+			p_data->k_start = L_MPI_HALO_DEPTH;
 		}
 #endif
 
@@ -697,21 +697,37 @@ long GridManager::getCellCount(int targetLevel, int targetRegion, double *bounds
 	unsigned int idx = 0;
 	if (targetLevel != 0) idx = targetLevel + targetRegion * L_NUM_LEVELS;
 
-	// If start of bounds outside end of grid, no union
+	// Edges of the target grid
+	double box[6];
+	for (int e = eXMin; e <= eZMax; ++e) box[e] = global_edges[e][idx];
+
+	return getCellCount(targetLevel, &box[0], bounds);
+}
+
+/// \brief	Returns the number of cells of a given level in the union between 
+///			the box and the bounds.
+///
+///	\param	targetLevel		grid level of the cells to be counted.
+///	\param	box				pointer to an array containing the edges of the box.
+///	\param	bounds			pointer to an array containing the bounds of the region to be checked.
+///	\returns				number of cells in the union.
+long GridManager::getCellCount(int targetLevel, double *box, double *bounds)
+{
+	// If start of bounds outside end of box, no union
 	if (
-		bounds[eXMin] > global_edges[eXMax][idx] ||
-		bounds[eYMin] > global_edges[eYMax][idx]
+		bounds[eXMin] > box[eXMax] ||
+		bounds[eYMin] > box[eYMax]
 #if (L_DIMS == 3)
-		|| bounds[eZMin] > global_edges[eZMax][idx]
+		|| bounds[eZMin] > box[eZMax]
 #endif
 		) return 0;
 
-	// If end of bounds is before the start of the grid, no union
+	// If end of bounds is before the start of the box, no union
 	if (
-		bounds[eXMax] < global_edges[eXMin][idx] ||
-		bounds[eYMax] < global_edges[eYMin][idx]
+		bounds[eXMax] < box[eXMin] ||
+		bounds[eYMax] < box[eYMin]
 #if (L_DIMS == 3)
-		|| bounds[eZMax] < global_edges[eZMin][idx]
+		|| bounds[eZMax] < box[eZMin]
 #endif
 		) return 0;
 
@@ -719,13 +735,13 @@ long GridManager::getCellCount(int targetLevel, int targetRegion, double *bounds
 
 	// Create store for the union edges
 	double union_bounds[6];
-	union_bounds[eXMin] = (bounds[eXMin] > global_edges[eXMin][idx]) ? bounds[eXMin] : global_edges[eXMin][idx];
-	union_bounds[eXMax] = (bounds[eXMax] < global_edges[eXMax][idx]) ? bounds[eXMax] : global_edges[eXMax][idx];
-	union_bounds[eYMin] = (bounds[eYMin] > global_edges[eYMin][idx]) ? bounds[eYMin] : global_edges[eYMin][idx];
-	union_bounds[eYMax] = (bounds[eYMax] < global_edges[eYMax][idx]) ? bounds[eYMax] : global_edges[eYMax][idx];
+	union_bounds[eXMin] = (bounds[eXMin] > box[eXMin]) ? bounds[eXMin] : box[eXMin];
+	union_bounds[eXMax] = (bounds[eXMax] < box[eXMax]) ? bounds[eXMax] : box[eXMax];
+	union_bounds[eYMin] = (bounds[eYMin] > box[eYMin]) ? bounds[eYMin] : box[eYMin];
+	union_bounds[eYMax] = (bounds[eYMax] < box[eYMax]) ? bounds[eYMax] : box[eYMax];
 #if (L_DIMS == 3)
-	union_bounds[eZMin] = (bounds[eZMin] > global_edges[eZMin][idx]) ? bounds[eZMin] : global_edges[eZMin][idx];
-	union_bounds[eZMax] = (bounds[eZMax] < global_edges[eZMax][idx]) ? bounds[eZMax] : global_edges[eZMax][idx];
+	union_bounds[eZMin] = (bounds[eZMin] > box[eZMin]) ? bounds[eZMin] : box[eZMin];
+	union_bounds[eZMax] = (bounds[eZMax] < box[eZMax]) ? bounds[eZMax] : box[eZMax];
 #endif
 
 
@@ -735,12 +751,73 @@ long GridManager::getCellCount(int targetLevel, int targetRegion, double *bounds
 	volume *= (union_bounds[eZMax] - union_bounds[eZMin]);
 #endif
 
-	// Use knowledge of discretisation to return the number of cells in union
+	// Use knowledge of discretisation to return the number of cells in union (rounded as volume is inexact)
 	double base_cell_size = L_COARSE_SITE_WIDTH;
 	double local_cell_size = base_cell_size / pow(2, targetLevel);
 #if (L_DIMS == 3)
-	return static_cast<long>(volume / (local_cell_size * local_cell_size * local_cell_size));
+	return static_cast<long>(std::round(volume / (local_cell_size * local_cell_size * local_cell_size)));
 #else
-	return static_cast<long>(volume / (local_cell_size * local_cell_size));
+	return static_cast<long>(std::round(volume / (local_cell_size * local_cell_size)));
+#endif
+}
+
+/// \brief	Returns the estimated cost of the operations within the bounds 
+///			weighted by site type.
+///
+///			Starts from the active operations count, in which every site costs 
+///			the same as a fluid site, and corrects it for the solid sites in the 
+///			domain walls and the transition layer sites of each sub-grid using 
+///			the cost weights from the definitions file. Site types which depend 
+///			on bodies are not known before the grids are built and are not 
+///			included.
+///
+///	\param	bounds	pointer to an array containing the bounds of the region to be considered.
+///	\returns		estimated cost in units of fluid site operations.
+double GridManager::getActiveCellCost(double *bounds)
+{
+	// All sites treated as fluid
+	double cost = static_cast<double>(getActiveCellCount(bounds, true));
+
+	// Box containing the sites between the solid walls
+	double box[6];
+	for (int e = eXMin; e <= eZMax; ++e) box[e] = global_edges[e][0];
+	if (L_WALL_LEFT == eSolid) box[eXMin] += L_WALL_THICKNESS_LEFT;
+	if (L_WALL_RIGHT == eSolid) box[eXMax] -= L_WALL_THICKNESS_RIGHT;
+	if (L_WALL_BOTTOM == eSolid) box[eYMin] += L_WALL_THICKNESS_BOTTOM;
+	if (L_WALL_TOP == eSolid) box[eYMax] -= L_WALL_THICKNESS_TOP;
+#if (L_DIMS == 3)
+	if (L_WALL_FRONT == eSolid) box[eZMin] += L_WALL_THICKNESS_FRONT;
+	if (L_WALL_BACK == eSolid) box[eZMax] -= L_WALL_THICKNESS_BACK;
 #endif
-}
\ No newline at end of file
+
+	// Correct for the cost of the wall sites
+	long solidCells = getCellCount(0, 0, bounds) - getCellCount(0, &box[0], bounds);
+	cost += (L_MPI_COST_SOLID - 1.0) * static_cast<double>(solidCells);
+
+	// Correct for the cost of the transition layer on each sub-grid
+	for (int reg = 0; reg < L_NUM_REGIONS; ++reg)
+	{
+		for (int lev = 1; lev <= L_NUM_LEVELS; ++lev)
+		{
+			int idx = lev + reg * L_NUM_LEVELS;
+
+			// Transition layer is one parent cell thick on non-periodic edges
+			double parent_dh = L_COARSE_SITE_WIDTH / pow(2, lev - 1);
+			for (int d = 0; d < L_DIMS; ++d)
+			{
+				box[2 * d] = global_edges[2 * d][idx];
+				box[2 * d + 1] = global_edges[2 * d + 1][idx];
+				if (!periodic_flags[d][idx])
+				{
+					box[2 * d] += parent_dh;
+					box[2 * d + 1] -= parent_dh;
+				}
+			}
+
+			long tlCells = getCellCount(lev, reg, bounds) - getCellCount(lev, &box[0], bounds);
+			cost += (L_MPI_COST_TRANSITION - 1.0) * static_cast<double>(tlCells) * pow(2, lev);
+		}
+	}
+
+	return cost;
+}
@@ -208,20 +208,20 @@ void GridObj::LBM_initGrid() {
 	
 	// Create position vectors using receiver layers as reference positions for wrapping
 	// X
-	if (MpiManager::getInstance()->dimensions[eXDirection] == 1)
+	if (!MpiManager::getInstance()->mpi_hasHalo(eXDirection, MpiManager::getInstance()->my_rank))
 		LBM_initPositionVector(gm->global_edges[eXMin][0] + dh / 2.0, gm->global_edges[eXMax][0] - dh / 2.0, eXDirection);
 	else
 		LBM_initPositionVector(mpim->recv_layer_pos.X[eLeftMin] + dh / 2.0, mpim->recv_layer_pos.X[eRightMax] - dh / 2.0, eXDirection);
 
 	// Y
-	if (MpiManager::getInstance()->dimensions[eYDirection] == 1)
+	if (!MpiManager::getInstance()->mpi_hasHalo(eYDirection, MpiManager::getInstance()->my_rank))
 		LBM_initPositionVector(gm->global_edges[eYMin][0] + dh / 2.0, gm->global_edges[eYMax][0] - dh / 2.0, eYDirection);
 	else
 		LBM_initPositionVector(mpim->recv_layer_pos.Y[eLeftMin] + dh / 2.0, mpim->recv_layer_pos.Y[eRightMax] - dh / 2.0, eYDirection);
 
 	// Z
 #if (L_DIMS == 3)
-	if (MpiManager::getInstance()->dimensions[eZDirection] == 1)
+	if (!MpiManager::getInstance()->mpi_hasHalo(eZDirection, MpiManager::getInstance()->my_rank))
 		LBM_initPositionVector(gm->global_edges[eZMin][0] + dh / 2.0, gm->global_edges[eZMax][0] - dh / 2.0, eZDirection);
 	else
 		LBM_initPositionVector(mpim->recv_layer_pos.Z[eLeftMin] + dh / 2.0, mpim->recv_layer_pos.Z[eRightMax] - dh / 2.0, eZDirection);
@@ -277,12 +277,6 @@ void GridObj::LBM_initGrid() {
 	// Velocity field
 	u.resize(N_lim * M_lim * K_lim * L_DIMS);
 	LBM_initVelocity();
-	
-#ifdef L_IBM_ON
-	// Set start-of-timestep-velocity
-	u_n.resize(N_lim * M_lim * K_lim * L_DIMS);
-	u_n = u;
-#endif
 
 	// Density field
 	rho.resize(N_lim * M_lim * K_lim);
@@ -462,12 +456,6 @@ void GridObj::LBM_initSubGrid (GridObj& pGrid)
 	u.resize(N_lim * M_lim * K_lim * L_DIMS);
 	LBM_initVelocity();
 
-	// Set start-of-timestep-velocity
-#ifdef L_IBM_ON
-	u_n.resize(N_lim * M_lim * K_lim * L_DIMS);
-	u_n = u;
-#endif
-
 	// Density
 	rho.resize(N_lim * M_lim * K_lim);
 	LBM_initRho();
@@ -869,14 +857,17 @@ void GridObj::LBM_initGridToGridMappings(GridObj& pGrid)
 #endif
 
 	/* If sub-grid wraps periodically we do not support it wrapping back round to the same rank
-	* again as this will confuse the mapping function so we error here. */
+	* again as this will confuse the mapping function so we error here. A non-periodic sub-grid
+	* within L_MPI_HALO_DEPTH coarse cells of the domain edge ends up here too as the halo 
+	* wraps round onto it. */
 
 	std::string dir;
 	if (CoarseLimsX[eMaximum] < CoarseLimsX[eMinimum] && CoarseLimsX[eMinimum] - 1 != CoarseLimsX[eMaximum]) dir = "X";
 	if (CoarseLimsY[eMaximum] < CoarseLimsY[eMinimum] && CoarseLimsY[eMinimum] - 1 != CoarseLimsY[eMaximum]) dir = "Y";
 	if (CoarseLimsZ[eMaximum] < CoarseLimsZ[eMinimum] && CoarseLimsZ[eMinimum] - 1 != CoarseLimsZ[eMaximum]) dir = "Z";
 	if (dir != "")
-		L_ERROR("Refined region wraps periodically in " + dir + "-direction but is not connected which is not supported. Exiting.", GridUtils::logfile);
+		L_ERROR("Refined region wraps periodically in " + dir + "-direction but is not connected which is not supported. "
+			"Keep refined regions at least L_MPI_HALO_DEPTH coarse cells from the domain edge. Exiting.", GridUtils::logfile);
 
 #ifdef L_INIT_VERBOSE
 	*GridUtils::logfile << "Local Coarse Lims are " <<
@@ -591,30 +591,16 @@ void GridObj::io_restart(eIOFlag IO_flag) {
 // *****************************************************************************
 /// \brief	Probe writer.
 ///
-///			This routine writes the quantities at the probe locations to a single 
-///			file.
+///			This routine finds the quantities at the probe locations owned by 
+///			this rank. In parallel the values are summed onto the master rank 
+///			with a non-blocking reduction which is completed and written to a 
+///			single file at the next probe output (or by io_probeFlush()) so the 
+///			ranks are not synchronised.
 void GridObj::io_probeOutput() {
 
-	int rank = GridUtils::safeGetRank();
-
 	// Declarations
-	std::ofstream probefile;
 	int i, j, d;
 	double x, y, z;
-
-	if (t == 0 && rank == 0) {
-		// Overwrite existing first time through
-		probefile.open(GridUtils::path_str + "/probe.out", std::ios::out);
-	} else {
-		// Append to existing
-		probefile.open(GridUtils::path_str + "/probe.out", std::ios::out | std::ios::app);
-	}
-	probefile.precision(L_OUTPUT_PRECISION);
-
-	// Start a new line if first rank
-	if (rank == 0 && t != 0) probefile << std::endl;
-
-	// Declarations
 	eLocationOnRank loc = eNone;
 	GridObj *g = nullptr;
 	std::vector<int> ijk;
@@ -628,8 +614,16 @@ void GridObj::io_probeOutput() {
 #if (L_DIMS == 3)
 	if (cNumProbes[2] > 1)
 		pspace[2] = abs(cProbeLimsZ[1] - cProbeLimsZ[0]) / (cNumProbes[2] - 1);
+	int numProbes = cNumProbes[0] * cNumProbes[1] * cNumProbes[2];
+#else
+	int numProbes = cNumProbes[0] * cNumProbes[1];
 #endif
 
+	/* Values are stored as a flag indicating the probe is on this rank
+	 * followed by three velocity components and the density. */
+	std::vector<double> values(5 * numProbes, 0.0);
+	int p = 0;
+
 	// Loop over probe points to compute positions
 	for (i = 0; i < cNumProbes[0]; i++) {
 		x = cProbeLimsX[0] + i*pspace[0];
@@ -665,17 +659,13 @@ void GridObj::io_probeOutput() {
 						// As long as not on a TL to finer we can use it
 						if (g->LatTyp(ijk[0], ijk[1], ijk[2], g->M_lim, g->K_lim) == eTransitionToFiner) continue;
 
-						// Write out velocity components and add tab
+						// Store velocity components and density
+						values[5 * p] = 1.0;
 						for (d = 0; d < L_DIMS; d++)
 						{
-							probefile << g->u(ijk[0], ijk[1], ijk[2], d, g->M_lim, g->K_lim, L_DIMS) << "\t";
+							values[5 * p + 1 + d] = g->u(ijk[0], ijk[1], ijk[2], d, g->M_lim, g->K_lim, L_DIMS);
 						}
-#if (L_DIMS != 3)
-						probefile << 0 << "\t";
-#endif
-
-						// Write out density
-						probefile << g->rho(ijk[0], ijk[1], ijk[2], g->M_lim, g->K_lim) << "\t";
+						values[5 * p + 4] = g->rho(ijk[0], ijk[1], ijk[2], g->M_lim, g->K_lim);
 
 						bProbeWritten = true;
 						break;
@@ -685,12 +675,88 @@ void GridObj::io_probeOutput() {
 					if (bProbeWritten) break;
 				}
 
+				p++;
 			}
 		}
 	}
 
-	probefile.close();
+#ifdef L_BUILD_FOR_MPI
+	MpiManager *mpim = MpiManager::getInstance();
+
+	// Write out the previous probe values if still pending
+	io_probeFlush();
+
+	// Sum onto the master rank without waiting
+	mpim->probe_send_buffer.swap(values);
+	mpim->probe_recv_buffer.resize(mpim->probe_send_buffer.size());
+	mpim->probe_time = t;
+	MPI_Ireduce(mpim->probe_send_buffer.data(), mpim->probe_recv_buffer.data(), 5 * numProbes, 
+		MPI_DOUBLE, MPI_SUM, 0, mpim->world_comm, &mpim->probe_request);
+#else
+	io_probeWrite(values, t);
+#endif
+
+}
+
+// *****************************************************************************
+/// \brief	Complete any pending probe output.
+///
+///			Waits for the outstanding reduction of probe values (if any) and 
+///			writes them out. Must be called by all ranks before finishing.
+void GridObj::io_probeFlush() {
 
+#ifdef L_BUILD_FOR_MPI
+	MpiManager *mpim = MpiManager::getInstance();
+	if (mpim->probe_request == MPI_REQUEST_NULL) return;
+
+	// Complete the reduction
+	clock_t t_start = clock();
+	MPI_Wait(&mpim->probe_request, MPI_STATUS_IGNORE);
+	mpim->diagnostics_wait_time += static_cast<double>(clock() - t_start) / CLOCKS_PER_SEC;
+
+	// Write out on master rank
+	if (mpim->my_rank == 0) io_probeWrite(mpim->probe_recv_buffer, mpim->probe_time);
+#endif
+
+}
+
+// *****************************************************************************
+/// \brief	Write a set of probe values to the probe file.
+///
+///			A line is written per output with the velocity components and 
+///			density of every probe found on the grids.
+///
+/// \param	values	flag, velocity components and density of each probe.
+/// \param	tval	time step at which the values were taken.
+void GridObj::io_probeWrite(std::vector<double>& values, int tval) {
+
+	std::ofstream probefile;
+
+	if (tval == 0) {
+		// Overwrite existing first time through
+		probefile.open(GridUtils::path_str + "/probe.out", std::ios::out);
+	} else {
+		// Append to existing
+		probefile.open(GridUtils::path_str + "/probe.out", std::ios::out | std::ios::app);
+	}
+	probefile.precision(L_OUTPUT_PRECISION);
+
+	// Start a new line
+	if (tval != 0) probefile << std::endl;
+
+	for (size_t p = 0; p < values.size(); p += 5)
+	{
+		// Skip probes which are not on any grid
+		if (values[p] == 0.0) continue;
+
+		// Write out velocity components and density (averaged if found more than once)
+		for (int d = 1; d < 5; d++)
+		{
+			probefile << values[p + d] / values[p] << "\t";
+		}
+	}
+
+	probefile.close();
 
 }
 
@@ -112,10 +112,6 @@ void GridObj::LBM_multi_opt(int subcycle)
 		}
 	}
 
-	// Set post-LBM macros
-	if (objman->hasFlexibleBodies[level])
-		u_n = u;
-
 	// Perform IBM steps (interpolate, force calc, spread and update macro)
 	if (objman->hasIBMBodies[level])
 		objman->ibm_apply(this, true);
@@ -177,6 +173,17 @@ void GridObj::LBM_multi_opt(int subcycle)
 	timeav_timestep += ((double)secs) / CLOCKS_PER_SEC;
 	timeav_timestep /= t;
 
+#if (defined L_BUILD_FOR_MPI && defined L_MPI_DYNAMIC_BALANCE)
+	// Accumulate compute time for load balancing
+	MpiManager::getInstance()->balance_compute_time += ((double)secs) / CLOCKS_PER_SEC;
+#endif
+
+#ifdef L_BUILD_FOR_MPI
+	// Accumulate compute time for the wait report
+	MpiManager::getInstance()->step_compute_time += ((double)secs) / CLOCKS_PER_SEC;
+	if (level == 0) MpiManager::getInstance()->step_count++;
+#endif
+
 	if (t % L_GRID_OUT_FREQ == 0) {
 		// Performance data to logfile
 		*GridUtils::logfile << "Grid " << level << ": Time stepping taking an average of " << timeav_timestep * 1000 << "ms" << std::endl;
@@ -186,7 +193,7 @@ void GridObj::LBM_multi_opt(int subcycle)
 #ifdef L_BUILD_FOR_MPI
 
 	// Launch communication on this grid by passing its level and region number
-	MpiManager::getInstance()->mpi_communicate(level, region_number);
+	MpiManager::getInstance()->mpi_communicate(level, region_number, subcycle);
 
 #endif
 
@@ -1328,6 +1335,25 @@ void GridObj::_LBM_resetForces()
 #endif
 }
 
+// *****************************************************************************
+/// \brief	Method to reset body forces at a single site.
+///
+///			Resets Cartesian force vector at the given site to zero or the 
+///			gravity force if enabled.
+///
+///	\param	id	flat index of the grid site.
+void GridObj::_LBM_resetForces(int id)
+{
+
+	// Reset Cartesian force vector on this grid site
+#ifdef L_GRAVITY_ON
+	force_xyz[L_GRAVITY_DIRECTION + id * L_DIMS] = rho[id] * gravity * refinement_ratio;
+#else
+	for (int d = 0; d < L_DIMS; d++)
+		force_xyz[d + id * L_DIMS] = 0.0;
+#endif
+}
+
 
 // *****************************************************************************
 /// \brief	Method to update macroscopic quantities on the fly and extrapolate from them.
@@ -386,6 +386,155 @@ std::vector<double> GridUtils::solveLinearSystem(std::vector<std::vector<double>
 	return b;
 }
 
+// *****************************************************************************
+///	\brief	Solve the sparse linear system A.x = b
+///
+///			Uses BiCGStab with a Jacobi preconditioner so A need not be 
+///			symmetric. A is held in compressed row storage: the entries of 
+///			row i are vals[rowStart[i]] to vals[rowStart[i+1]-1] in the 
+///			columns given by cols. If the iteration breaks down it restarts 
+///			from the current solution. If it fails to converge it restarts from 
+///			the best iterate a few times and then returns the best iterate 
+///			with a warning, so the matrix is never formed densely.
+///
+///	\param	rowStart	index of the first entry of each row (plus one past the end)
+///	\param	cols		column of each entry
+///	\param	vals		value of each entry
+///	\param	b			b vector (RHS)
+///	\param	x0			initial guess (zero if empty)
+///	\param	tol			residual relative to the RHS at which to stop
+///	\return	x
+std::vector<double> GridUtils::solveSparseLinearSystem(const std::vector<int> &rowStart, const std::vector<int> &cols, 
+	const std::vector<double> &vals, const std::vector<double> &b, const std::vector<double> &x0, double tol) {
+
+	size_t dim = b.size();
+	std::vector<double> x(dim, 0.0);
+	if (x0.size() == dim) x = x0;
+
+	// Sparse matrix-vector product
+	auto multiply = [&](const std::vector<double> &in, std::vector<double> &out) {
+		for (size_t i = 0; i < dim; i++) {
+			out[i] = 0.0;
+			for (int e = rowStart[i]; e < rowStart[i + 1]; e++)
+				out[i] += vals[e] * in[cols[e]];
+		}
+	};
+	auto dot = [](const std::vector<double> &u, const std::vector<double> &w) {
+		return std::inner_product(u.begin(), u.end(), w.begin(), 0.0);
+	};
+
+	// Inverse of the diagonal for preconditioning
+	std::vector<double> invDiag(dim, 1.0);
+	for (size_t i = 0; i < dim; i++) {
+		for (int e = rowStart[i]; e < rowStart[i + 1]; e++) {
+			if (cols[e] == static_cast<int>(i) && vals[e] != 0.0) invDiag[i] = 1.0 / vals[e];
+		}
+	}
+
+	// Check the initial guess
+	std::vector<double> r(dim), rHat(dim), p(dim), v(dim), pHat(dim), s(dim), sHat(dim), t(dim);
+	double bNorm = std::sqrt(dot(b, b));
+	if (bNorm == 0.0) return std::vector<double>(dim, 0.0);
+	multiply(x, r);
+	for (size_t i = 0; i < dim; i++) r[i] = b[i] - r[i];
+	double resBest = std::sqrt(dot(r, r));
+	if (resBest < tol * bNorm) return x;
+	std::vector<double> xBest(x);
+
+	/* Krylov methods converge within dim iterations in exact arithmetic so 
+	 * allow twice that for round-off in each cycle. If a cycle ends without 
+	 * converging the next one starts again from the best iterate found with 
+	 * its true residual, which also clears the drift in the updated residual. */
+	size_t maxIter = std::min(static_cast<size_t>(1000), std::max(static_cast<size_t>(50), 2 * dim));
+	const int maxCycles = 4;
+
+	// Dot products smaller than this relative to the vector lengths mean breakdown
+	const double breakdown = 1e-14;
+
+	for (int cycle = 0; cycle < maxCycles; cycle++) {
+
+		// Restart from the best iterate
+		if (cycle > 0) {
+			x = xBest;
+			multiply(x, r);
+			for (size_t i = 0; i < dim; i++) r[i] = b[i] - r[i];
+		}
+
+		// Iterate, restarting from the current residual on breakdown
+		double rho = 1.0, alpha = 1.0, omega = 1.0;
+		bool restart = true;
+		for (size_t it = 0; it < maxIter; it++) {
+
+			if (restart) {
+				rHat = r;
+				std::fill(p.begin(), p.end(), 0.0);
+				std::fill(v.begin(), v.end(), 0.0);
+				rho = alpha = omega = 1.0;
+				restart = false;
+			}
+
+			double rhoNew = dot(rHat, r);
+			if (std::abs(rhoNew) <= breakdown * std::sqrt(dot(rHat, rHat) * dot(r, r))) {
+				restart = true;
+				continue;
+			}
+			double beta = (rhoNew / rho) * (alpha / omega);
+			rho = rhoNew;
+			for (size_t i = 0; i < dim; i++) {
+				p[i] = r[i] + beta * (p[i] - omega * v[i]);
+				pHat[i] = invDiag[i] * p[i];
+			}
+			multiply(pHat, v);
+			double rHatV = dot(rHat, v);
+			if (std::abs(rHatV) <= breakdown * std::sqrt(dot(rHat, rHat) * dot(v, v))) {
+				restart = true;
+				continue;
+			}
+			alpha = rho / rHatV;
+
+			// Half step
+			for (size_t i = 0; i < dim; i++) s[i] = r[i] - alpha * v[i];
+			if (std::sqrt(dot(s, s)) < tol * bNorm) {
+				for (size_t i = 0; i < dim; i++) x[i] += alpha * pHat[i];
+				return x;
+			}
+
+			// Full step (keep the half step if it cannot be taken)
+			for (size_t i = 0; i < dim; i++) sHat[i] = invDiag[i] * s[i];
+			multiply(sHat, t);
+			double tt = dot(t, t);
+			omega = (tt > 0.0 ? dot(t, s) / tt : 0.0);
+			if (omega == 0.0) {
+				for (size_t i = 0; i < dim; i++) x[i] += alpha * pHat[i];
+				r = s;
+				restart = true;
+			}
+			else {
+				for (size_t i = 0; i < dim; i++) {
+					x[i] += alpha * pHat[i] + omega * sHat[i];
+					r[i] = s[i] - omega * t[i];
+				}
+			}
+
+			// Keep the best iterate
+			double res = std::sqrt(dot(r, r));
+			if (res < tol * bNorm) return x;
+			if (res < resBest) {
+				resBest = res;
+				xBest = x;
+			}
+		}
+	}
+
+	// Return the best iterate found
+	std::stringstream resRel;
+	resRel << resBest / bNorm;
+	L_WARN("Sparse linear solve did not converge in " + std::to_string(maxCycles * maxIter) + 
+		" iterations. Using the best iterate with a residual of " + resRel.str() + 
+		" relative to the RHS.", GridUtils::logfile);
+	return xBest;
+}
+
 // *****************************************************************************
 /// \brief	Gets the indices of the fine site given the coarse site.
 ///
@@ -506,7 +655,7 @@ double GridUtils::normaliseToLink(double value, int v)
 /// \brief	Finds out whether halo containing i,j,k links to neighbour rank periodically.
 ///
 ///			Checks the receiver layer containing local site i,j,k and determines 
-///			from the MPI topology information whether this layer couples to an 
+///			from the rank core edges whether this layer couples to an 
 ///			adjacent or periodic neighbour rank. I.e. if the neighbour is physically 
 ///			next to the rank or whether it is actaully at the other side of the domain.
 ///
@@ -518,18 +667,11 @@ double GridUtils::normaliseToLink(double value, int v)
 bool GridUtils::isOverlapPeriodic(int i, int j, int k, GridObj const & g) {
 
 	// Local declarations
-	int exp_rank_coords[L_DIMS], act_rank_coords[L_DIMS], dimensions[L_DIMS];
 	int shift[3] = {0, 0, 0};
 
 	// Get MpiManager instance
 	MpiManager *mpim = MpiManager::getInstance();
-
-	// Initialise local variables
-	dimensions[0] = L_MPI_XCORES;
-	dimensions[1] = L_MPI_YCORES;
-#if (L_DIMS == 3)
-	dimensions[2] = L_MPI_ZCORES;
-#endif
+	GridManager *gm = GridManager::getInstance();
 
 	// Define shifts based on which overlap we are on
 
@@ -558,20 +700,18 @@ bool GridUtils::isOverlapPeriodic(int i, int j, int k, GridObj const & g) {
 
 	// Loop over each Cartesian direction
 	for (int d = 0; d < L_DIMS; d++) {
-		// Define expected (non-periodic) MPI coordinates of neighbour rank
-		exp_rank_coords[d] = mpim->rank_coords[d] + shift[d];
-
-		// Define actual MPI coordinates of neighbour rank (accounting for periodicity)
-		act_rank_coords[d] = (mpim->rank_coords[d] + shift[d] + dimensions[d]) % dimensions[d];
 
-		// If there is a difference then rank is periodically linked to its neighbour and the overlap
-		// site is from a periodic rank so return early
-		if (exp_rank_coords[d] != act_rank_coords[d]) return true;
+		// If the core touches the domain edge on the side of the halo then the
+		// neighbour is at the other side of the domain so return early
+		int edgeCell = static_cast<int>(std::round(
+			mpim->rank_core_edge[2 * d + (shift[d] == 1 ? 1 : 0)][mpim->my_rank] / L_COARSE_SITE_WIDTH));
+		if (shift[d] == 1 && edgeCell == gm->global_size[d][0]) return true;
+		if (shift[d] == -1 && edgeCell == 0) return true;
 	}
 	
 
-	// Expected and actual are the same so the neighbour rank is not periodically linked and the overlap site
-	// is from an adjacent neighbour not a periodic one.
+	// Halo is not at a domain edge so the overlap site is from an adjacent 
+	// neighbour not a periodic one.
 	return false;
 
 }
@@ -775,11 +915,6 @@ bool GridUtils::isOnThisRank(double xyz, eCartesianDirection dir,
 ///	\return	rank
 int GridUtils::getRankfromPosition(std::vector<double> &position) {
 
-	// TODO Search through the ranks using a self-organised list as more often than not the markers are going back to their original rank
-
-	// Get grid manager
-	GridManager *gm = GridManager::getInstance();
-
 	// Check if position is not witihn global grid limits
 	if (!GridUtils::isWithinDomain(position))
 		L_ERROR("Position is off entire grid hierarchy. Exiting.", GridUtils::logfile);
@@ -792,17 +927,29 @@ int GridUtils::getRankfromPosition(std::vector<double> &position) {
 	// Get MPI Manager instance
 	MpiManager *mpim = MpiManager::getInstance();
 
-	// Loop through all ranks
-	int rank;
-	for (rank = 0; rank < mpim->num_ranks; rank++) {
-
-		// Check if within the grid
-		if (position[eXDirection] >= mpim->rank_core_edge[eXMin][rank] && position[eXDirection] < mpim->rank_core_edge[eXMax][rank]
+	// Check if within the core of a rank
+	auto inCore = [&](int rank) -> bool
+	{
+		return (position[eXDirection] >= mpim->rank_core_edge[eXMin][rank] && position[eXDirection] < mpim->rank_core_edge[eXMax][rank]
 		 && position[eYDirection] >= mpim->rank_core_edge[eYMin][rank] && position[eYDirection] < mpim->rank_core_edge[eYMax][rank]
 #if (L_DIMS == 3)
 		 && position[eZDirection] >= mpim->rank_core_edge[eZMin][rank] && position[eZDirection] < mpim->rank_core_edge[eZMax][rank]
 #endif
-			) {
+			);
+	};
+
+	// Positions are nearly always on this rank or a neighbour so try those first
+	if (inCore(mpim->my_rank)) return mpim->my_rank;
+	for (int rank : mpim->neighbour_rank) {
+		if (inCore(rank)) return rank;
+	}
+
+	// Otherwise loop through all ranks
+	int rank;
+	for (rank = 0; rank < mpim->num_ranks; rank++) {
+
+		// Check if within the grid
+		if (inCore(rank)) {
 
 			// Return rank number
 			break;
@@ -1519,36 +1666,6 @@ bool GridUtils::isOffGrid(int i, int j, int k, GridObj const * const g) {
 	return false;
 }
 
-// ****************************************************************************
-/// \brief	Get direction in MPI topology from unit vector.
-///
-/// \param	offset_vector	unit vector pointing away from current rank.
-/// \return	MPI direction.
-int GridUtils::getMpiDirection(int offset_vector[])
-{
-
-	// Get Mpi Manager
-	MpiManager *mpim = MpiManager::getInstance();
-
-	// Loop over the directions
-	for (int d = 0; d < L_MPI_DIRS; ++d)
-	{
-		if (offset_vector[0] == mpim->neighbour_vectors[0][d] &&
-			offset_vector[1] == mpim->neighbour_vectors[1][d]
-
-#if (L_DIMS == 3)
-			&& offset_vector[2] == mpim->neighbour_vectors[2][d]
-#endif
-			)
-		{
-			return d;
-		}
-	}
-
-	return -1;
-
-}
-
 // ****************************************************************************
 /// \brief	Get local voxel indices on grid in which provided position lies.
 ///
@@ -1677,13 +1794,14 @@ void GridUtils::getEnclosingVoxel(double xyz, GridObj const * const g, eCartesia
 	/* Compute the offset required based on certain conditions */
 
 	// If grid starts on a grid to the left then the offset is at most halo cells
-	if (cellsGridStartToRankStart > static_cast<int>(1.0 / g->refinement_ratio))
-		offset = static_cast<int>(1.0 / g->refinement_ratio);
+	int haloCells = static_cast<int>(L_MPI_HALO_DEPTH / g->refinement_ratio);
+	if (cellsGridStartToRankStart > haloCells)
+		offset = haloCells;
 	else
 		offset = cellsGridStartToRankStart;
 
-	// If on L0, always add a halo offset of 1 for MPI builds
-	if (g->level == 0) offset = 1;
+	// If on L0, add a full halo offset for MPI builds unless the block has no halo in this direction
+	if (g->level == 0) offset = (mpim->mpi_hasHalo(dir, rank) ? L_MPI_HALO_DEPTH : 0);
 
 #endif // L_BUILD_FOR_MPI
 
@@ -22,18 +22,11 @@
 
 #include "../inc/stdafx.h"
 #include "../inc/GridObj.h"
+#include "../inc/ObjectManager.h"
 
 // Static declarations
 MpiManager* MpiManager::me;
 
-// Although I don't want this to be static VC++ 2013 doesn't support constructor initialiser lists
-const int MpiManager::neighbour_vectors[3][26] = 
-{
-	{ 1, -1, 1, -1, 0, 0, -1, 1, 0, 0, 1, -1, 1, -1, 0, 0, -1, 1, -1, 1, -1, 1, 0, 0, 1, -1 },
-	{ 0, 0, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 0, 0, -1, 1, -1, 1, -1, 1 },
-	{ 0, 0, 0, 0, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1 }
-};
-
 // ****************************************************************************
 /// Default constructor
 MpiManager::MpiManager()
@@ -50,9 +43,24 @@ MpiManager::MpiManager()
 
 #endif
 
-	// Resize buffer arrays based on number of MPI directions
-	f_buffer_send.resize(L_MPI_DIRS, std::vector<double>(0));
-	f_buffer_recv.resize(L_MPI_DIRS, std::vector<double>(0));	
+	// No load measured yet
+	balance_compute_time = 0.0;
+
+	// No diagnostics outstanding
+	probe_request = MPI_REQUEST_NULL;
+	probe_time = 0;
+	step_compute_time = 0.0;
+	step_count = 0;
+	wait_report_send = 0.0;
+	wait_report_recv[0] = wait_report_recv[1] = 0.0;
+	wait_report_steps = 0;
+	wait_report_requests[0] = wait_report_requests[1] = MPI_REQUEST_NULL;
+	diagnostics_wait_time = 0.0;
+
+	// Exchange halos every step until told otherwise
+	halo_exchange_interval.assign(L_NUM_LEVELS + 1, 1);
+	halo_exchange_depth.assign(L_NUM_LEVELS + 1, L_MPI_HALO_DEPTH);
+	halo_single_precision.assign(L_NUM_LEVELS + 1, false);
 
 	// Initialise the manager, grid information and topology
 	mpi_init();
@@ -62,6 +70,7 @@ MpiManager::MpiManager()
 	markerCommMarkerSide.resize(L_NUM_LEVELS+1);
 	supportCommMarkerSide.resize(L_NUM_LEVELS+1);
 	supportCommSupportSide.resize(L_NUM_LEVELS+1);
+	ibm_comm_plan.resize(L_NUM_LEVELS+1);
 }
 
 /// \brief	Default destructor.
@@ -103,24 +112,43 @@ void MpiManager::destroyInstance() {
 void MpiManager::mpi_init()
 {
 
-	// Create communicator and topology
-	int MPI_periodic[3], MPI_reorder;
-	MPI_reorder = true;
+	// Requested topology (zero entries are chosen at runtime)
+#ifdef L_MPI_RCB
+	// Blocks are not arranged in a Cartesian topology so any number of processes is valid
+	dimensions[0] = 0;
+	dimensions[1] = 0;
+	dimensions[2] = (L_DIMS == 3) ? 0 : 1;
+#else
 	dimensions[0] = L_MPI_XCORES;
 	dimensions[1] = L_MPI_YCORES;
 	dimensions[2] = L_MPI_ZCORES;
-	MPI_periodic[0] = true;
-	MPI_periodic[1] = true;
-	MPI_periodic[2] = true;
+#endif
 
-	MPI_Cart_create(MPI_COMM_WORLD, L_DIMS, &dimensions[0], &MPI_periodic[0], MPI_reorder, &world_comm);
+	// Check the fixed directions can be filled by the processes available
+	int world_size;
+	MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+	int fixedRanks = 1;
+	bool allFixed = true;
+	for (int d = 0; d < L_DIMS; d++)
+	{
+		if (dimensions[d] != 0) fixedRanks *= dimensions[d];
+		else allFixed = false;
+	}
+	if (fixedRanks <= 0 || world_size % fixedRanks != 0 || (allFixed && fixedRanks != world_size))
+	{
+		/* The logfile is not open yet so keep the message for mpi_gridbuild() 
+		 * to report and let MPI choose a valid topology in the meantime. */
+		topology_error = "MPI topology " + std::to_string(dimensions[0]) + "x" + std::to_string(dimensions[1]) + 
+			"x" + std::to_string(dimensions[2]) + " does not match the " + std::to_string(world_size) + 
+			" processes available.";
+		for (int d = 0; d < L_DIMS; d++) dimensions[d] = 0;
+	}
 
-	// Get Cartesian topology info
-	MPI_Comm_rank(world_comm, &my_rank);
-	MPI_Comm_size(world_comm, &num_ranks);
+	// Fill in any free directions to suit the number of processes available
+	MPI_Dims_create(world_size, L_DIMS, &dimensions[0]);
 
-	// Store coordinates in the new topology
-	MPI_Cart_coords(world_comm, my_rank, L_DIMS, rank_coords);
+	// Create communicator and topology
+	mpi_setTopology(MPI_COMM_WORLD, true);
 
 	// Output directory creation (only master rank)
 	if (my_rank == 0) GridUtils::createOutputDirectory(GridUtils::path_str);
@@ -158,42 +186,341 @@ void MpiManager::mpi_init()
 	L_INFO(msg, logout);
 #endif
 
+	// End Initialisation //
 
-	// Get neighbour ID //
+	return;
+}
 
-	// Loop over grid direction
-	for (int dir = 0; dir < L_MPI_DIRS; dir++) {
+// ************************************************************************* //
+/// \brief	Create the Cartesian topology.
+///
+///			Creates the world communicator from the supplied communicator using 
+///			the current values of dimensions and stores the rank, size and 
+///			coordinates of this process in the new topology, as well as the 
+///			shared-memory node holding each rank.
+///
+///	\param	base_comm	communicator from which to build the topology.
+///	\param	reorder		flag to allow MPI to reorder the ranks.
+void MpiManager::mpi_setTopology(MPI_Comm base_comm, int reorder)
+{
+	// Create communicator and topology
+	int MPI_periodic[3];
+	MPI_periodic[0] = true;
+	MPI_periodic[1] = true;
+	MPI_periodic[2] = true;
 
-		MPI_Barrier(world_comm);
+	MPI_Cart_create(base_comm, L_DIMS, &dimensions[0], &MPI_periodic[0], reorder, &world_comm);
 
-		// Get coordinates of neighbour (taking into account periodic structure)
-		int coord_tmp[L_DIMS];
-		for (size_t d = 0; d < L_DIMS; d++) {
-			neighbour_coords[d][dir] = (rank_coords[d] + neighbour_vectors[d][dir] + dimensions[d]) % dimensions[d];
-			coord_tmp[d] = neighbour_coords[d][dir];	// Store single vector for getting neighbour rank
+	// Get Cartesian topology info
+	MPI_Comm_rank(world_comm, &my_rank);
+	MPI_Comm_size(world_comm, &num_ranks);
+
+	// Store coordinates in the new topology
+	MPI_Cart_coords(world_comm, my_rank, L_DIMS, rank_coords);
+
+	// Identify each node by the lowest rank it holds
+	MPI_Comm shared_comm;
+	MPI_Comm_split_type(world_comm, MPI_COMM_TYPE_SHARED, my_rank, MPI_INFO_NULL, &shared_comm);
+	int leader = my_rank;
+	MPI_Bcast(&leader, 1, MPI_INT, 0, shared_comm);
+	MPI_Comm_free(&shared_comm);
+	rank_node.resize(num_ranks);
+	MPI_Allgather(&leader, 1, MPI_INT, rank_node.data(), 1, MPI_INT, world_comm);
+
+	// Number the nodes consecutively
+	std::vector<int> leaders(rank_node);
+	std::sort(leaders.begin(), leaders.end());
+	leaders.erase(std::unique(leaders.begin(), leaders.end()), leaders.end());
+	for (int rank = 0; rank < num_ranks; ++rank)
+		rank_node[rank] = static_cast<int>(std::lower_bound(leaders.begin(), leaders.end(), rank_node[rank]) - leaders.begin());
+}
+
+// ************************************************************************* //
+/// \brief	Place the blocks of the Cartesian topology on the nodes.
+///
+///			The ranks sharing memory form a node. If every node holds the same 
+///			number of ranks the process grid is divided into equal sub-blocks 
+///			and each node is given one, choosing the shape which minimises the 
+///			halo traffic between nodes. The traffic across a face between two 
+///			blocks is estimated by the active operations in the layer of cells 
+///			next to it so refined regions are accounted for. If this improves 
+///			on the current placement the ranks are renumbered so that rank 
+///			numbers keep their Cartesian coordinates and block edges but each 
+///			process takes the block assigned to its node. Must be called after 
+///			the block edges are known and before the grids are built. Called by 
+///			all ranks.
+///
+///	\param	grid_man	pointer to an initialised grid manager.
+///	\returns			true if the ranks were renumbered.
+bool MpiManager::mpi_placeRanksOnNodes(GridManager* const grid_man)
+{
+	double dh = L_COARSE_SITE_WIDTH;
+	int numNodes = *std::max_element(rank_node.begin(), rank_node.end()) + 1;
+	if (numNodes == 1) return false;
+
+	// Ranks on this node in order and the node sizes
+	std::vector<int> nodeRanks;
+	std::vector<int> nodeSize(numNodes, 0);
+	for (int rank = 0; rank < num_ranks; ++rank)
+	{
+		if (rank_node[rank] == rank_node[my_rank]) nodeRanks.push_back(rank);
+		nodeSize[rank_node[rank]]++;
+	}
+	int ranksPerNode = nodeSize[0];
+	if (std::count(nodeSize.begin(), nodeSize.end(), ranksPerNode) != numNodes)
+	{
+		L_WARN("Nodes hold different numbers of ranks so ranks cannot be placed by node.", GridUtils::logfile);
+		return false;
+	}
+
+	// Traffic between nodes if the rank at each set of coordinates were on the given node
+	auto interNodeTraffic = [&](const std::function<int(int*)>& nodeOf)
+	{
+		double traffic = 0.0;
+		int coords[3] = { 0, 0, 0 }, nbrCoords[3];
+		for (int rank = 0; rank < num_ranks; ++rank)
+		{
+			MPI_Cart_coords(world_comm, rank, L_DIMS, &coords[0]);
+			for (int d = 0; d < L_DIMS; ++d)
+			{
+				if (dimensions[d] == 1) continue;
+
+				// Face with the next block in this direction (periodic)
+				std::copy(coords, coords + 3, nbrCoords);
+				nbrCoords[d] = (coords[d] + 1) % dimensions[d];
+				if (nodeOf(&coords[0]) == nodeOf(&nbrCoords[0])) continue;
+
+				// Active operations in the layer of cells on each side of the face
+				double bounds[6];
+				for (int e = 0; e < 6; ++e) bounds[e] = rank_core_edge[e][rank];
+				bounds[2 * d] = bounds[2 * d + 1] - dh;
+				traffic += 2.0 * grid_man->getActiveCellCount(&bounds[0], true);
+			}
+		}
+		return traffic;
+	};
+
+	// Traffic of the current placement
+	double currentTraffic = interNodeTraffic([&](int *c)
+	{
+		int rank;
+		MPI_Cart_rank(world_comm, c, &rank);
+		return rank_node[rank];
+	});
+
+	// Try every shape of sub-block which tiles the topology
+	int blockDims[3] = { 0, 0, 0 };
+	double bestTraffic = currentTraffic;
+	for (int a = 1; a <= dimensions[0]; ++a)
+	{
+		if (dimensions[0] % a != 0 || ranksPerNode % a != 0) continue;
+		for (int b = 1; b <= dimensions[1]; ++b)
+		{
+			if (dimensions[1] % b != 0 || (ranksPerNode / a) % b != 0) continue;
+			int c = ranksPerNode / (a * b);
+			if (dimensions[2] % c != 0) continue;
+
+			int block[3] = { a, b, c };
+			double traffic = interNodeTraffic([&](int *coords)
+			{
+				int nodeCoords[3];
+				for (int d = 0; d < 3; ++d) nodeCoords[d] = (d < L_DIMS ? coords[d] : 0) / block[d];
+				return (nodeCoords[0] * (dimensions[1] / b) + nodeCoords[1]) * (dimensions[2] / c) + nodeCoords[2];
+			});
+			if (traffic < bestTraffic)
+			{
+				bestTraffic = traffic;
+				std::copy(block, block + 3, blockDims);
+			}
 		}
+	}
 
-		// Get rank of neighbour and build vector of neighbour ranks
-		int tmp;
-		MPI_Cart_rank(world_comm, coord_tmp, &tmp);
-		neighbour_rank[dir] = tmp;
+	if (blockDims[0] == 0)
+	{
+		L_INFO("Current placement of ranks on nodes kept.", GridUtils::logfile);
+		return false;
+	}
 
-		MPI_Barrier(world_comm);
+	// Coordinates of the block taken by this process: sub-block of its node then position within it
+	int nodeGrid[3], coords[3];
+	for (int d = 0; d < 3; ++d) nodeGrid[d] = dimensions[d] / blockDims[d];
+	int node = rank_node[my_rank];
+	int local = static_cast<int>(std::find(nodeRanks.begin(), nodeRanks.end(), my_rank) - nodeRanks.begin());
+	int nodeCoords[3] = { node / (nodeGrid[1] * nodeGrid[2]), (node / nodeGrid[2]) % nodeGrid[1], node % nodeGrid[2] };
+	int localCoords[3] = { local / (blockDims[1] * blockDims[2]), (local / blockDims[2]) % blockDims[1], local % blockDims[2] };
+	for (int d = 0; d < 3; ++d) coords[d] = nodeCoords[d] * blockDims[d] + localCoords[d];
+	int newRank;
+	MPI_Cart_rank(world_comm, &coords[0], &newRank);
+
+	// Rebuild the topology from a communicator in the new order
+	int oldRank = my_rank;
+	MPI_Comm old_comm = world_comm;
+	MPI_Comm node_comm;
+	MPI_Comm_split(old_comm, 0, newRank, &node_comm);
+	mpi_setTopology(node_comm, false);
+	MPI_Comm_free(&node_comm);
+	MPI_Comm_free(&old_comm);
+
+	// Logs were opened under the old rank number
+	mpi_renameLogs(oldRank);
+
+	L_INFO("Ranks placed on nodes in blocks of " + std::to_string(blockDims[0]) + "x" + std::to_string(blockDims[1]) + "x" + 
+		std::to_string(blockDims[2]) + " reducing the estimated halo traffic between nodes by " + 
+		std::to_string(currentTraffic > 0.0 ? (currentTraffic - bestTraffic) * 100.0 / currentTraffic : 0.0) + "%.", GridUtils::logfile);
+
+	return true;
+}
 
+// ************************************************************************* //
+/// \brief	Rename the logs of this rank after the ranks are renumbered.
+///
+///			The logs are named after the rank number held when they were 
+///			opened. Each rank closes its logs and moves them to a temporary 
+///			name first so no rank overwrites a log another rank still has to 
+///			move. They are then given the new rank number and reopened for 
+///			appending. Called by all ranks.
+///
+///	\param	oldRank	rank number under which the logs were opened.
+void MpiManager::mpi_renameLogs(int oldRank)
+{
+	std::vector<std::string> names(1, "/log_rank");
+	std::vector<std::ofstream*> files(1, GridUtils::logfile);
 #ifdef L_MPI_VERBOSE
-		// Print out current neighbour coordinates and rank
-		*logout << "Neighbour in direction " << dir << " of rank " << my_rank << " is (";
-		for (size_t d = 0; d < L_DIMS; d++) {
-			*logout << "\t" << neighbour_coords[d][dir];
+	names.push_back("/mpi_log_rank");
+	files.push_back(logout);
+#endif
+
+	// Move to a temporary name unique to the new rank
+	for (size_t n = 0; n < files.size(); ++n)
+	{
+		files[n]->close();
+		std::string oldName = GridUtils::path_str + names[n] + std::to_string(oldRank) + ".log";
+		std::string tmpName = GridUtils::path_str + names[n] + std::to_string(my_rank) + ".log.tmp";
+		rename(oldName.c_str(), tmpName.c_str());
+	}
+	MPI_Barrier(world_comm);
+
+	// Give the new rank number and reopen
+	for (size_t n = 0; n < files.size(); ++n)
+	{
+		std::string newName = GridUtils::path_str + names[n] + std::to_string(my_rank) + ".log";
+		rename((newName + ".tmp").c_str(), newName.c_str());
+		files[n]->open(newName, std::ios::out | std::ios::app);
+	}
+	L_INFO("Log started as rank " + std::to_string(oldRank) + " before the ranks were renumbered.", GridUtils::logfile);
+}
+
+// ************************************************************************* //
+/// \brief	Build the list of ranks which exchange halo data with this rank.
+///
+///			A rank is a neighbour if its core overlaps the local grid of this 
+///			rank or if the core of this rank overlaps its local grid. Periodic 
+///			images of the blocks are considered. Only the block edges are used 
+///			so the blocks need not form a Cartesian topology. Must be called 
+///			whenever the block edges change.
+void MpiManager::mpi_setNeighbours()
+{
+	GridManager *gm = GridManager::getInstance();
+	double dh = L_COARSE_SITE_WIDTH;
+
+	// Does the core of rank a overlap the local grid (inc. halo) of rank b
+	auto overlaps = [&](int a, int b) -> bool
+	{
+		for (int d = 0; d < L_DIMS; ++d)
+		{
+			// Whole domain in this direction if no halo
+			if (!mpi_hasHalo(d, b)) continue;
+
+			double lo = rank_core_edge[2 * d][b] - L_MPI_HALO_DEPTH * dh;
+			double hi = rank_core_edge[2 * d + 1][b] + L_MPI_HALO_DEPTH * dh;
+			double L = gm->global_edges[2 * d + 1][0];
+
+			// Check core and its periodic images (overlaps must be at least half a cell)
+			bool bOverlap = false;
+			for (int image = -1; image <= 1; ++image)
+			{
+				double overlap =
+					std::min(hi, rank_core_edge[2 * d + 1][a] + image * L) -
+					std::max(lo, rank_core_edge[2 * d][a] + image * L);
+				if (overlap > 0.5 * dh) bOverlap = true;
+			}
+			if (!bOverlap) return false;
 		}
-		*logout << "\t): Rank " << neighbour_rank[dir] << std::endl;
+		return true;
+	};
+
+	// Loop over the other ranks
+	neighbour_rank.clear();
+	for (int rank = 0; rank < num_ranks; ++rank)
+	{
+		if (rank == my_rank) continue;
+		if (overlaps(rank, my_rank) || overlaps(my_rank, rank)) neighbour_rank.push_back(rank);
+	}
+
+	// Assign each neighbour to an exchange stage
+	neighbour_stage.assign(neighbour_rank.size(), 0);
+#ifdef L_MPI_FACE_EXCHANGE
+#ifdef L_MPI_RCB
+	// Face exchanges forward through neighbours which share whole faces
+	L_ERROR("Face exchanges require a Cartesian decomposition so cannot be used with L_MPI_RCB. Exiting.", GridUtils::logfile);
 #endif
+	for (size_t n = 0; n < neighbour_rank.size(); ++n)
+	{
+		// Face neighbours are separated from this rank in exactly one direction
+		int separated = 0;
+		for (int d = 0; d < L_DIMS; ++d)
+		{
+			double L = gm->global_edges[2 * d + 1][0];
+			bool bOverlap = false;
+			for (int image = -1; image <= 1; ++image)
+			{
+				double overlap =
+					std::min(rank_core_edge[2 * d + 1][my_rank], rank_core_edge[2 * d + 1][neighbour_rank[n]] + image * L) -
+					std::max(rank_core_edge[2 * d][my_rank], rank_core_edge[2 * d][neighbour_rank[n]] + image * L);
+				if (overlap > 0.5 * dh) bOverlap = true;
+			}
+			if (!bOverlap)
+			{
+				neighbour_stage[n] = d;
+				separated++;
+			}
+		}
+		if (separated != 1) neighbour_stage[n] = -1;
+	}
+#endif
+
+	// One buffer and send request per neighbour
+	f_buffer_send.assign(neighbour_rank.size(), std::vector<double>(0));
+	f_buffer_recv.assign(neighbour_rank.size(), std::vector<double>(0));
+	send_requests.resize(neighbour_rank.size());
+	send_stat.resize(neighbour_rank.size());
 
+#ifdef L_MPI_VERBOSE
+	// Print out neighbour ranks
+	*logout << "Neighbours of rank " << my_rank << " are (";
+	for (size_t n = 0; n < neighbour_rank.size(); n++) {
+		*logout << "\t" << neighbour_rank[n];
 	}
+	*logout << "\t)" << std::endl;
+#endif
+}
 
-	// End Initialisation //
+// ************************************************************************* //
+/// \brief	Check whether the block of a rank has a halo in a direction.
+///
+///			A block which spans the whole domain in a direction has no halo 
+///			in that direction and handles periodicity locally.
+///
+///	\param	dir		Cartesian direction.
+///	\param	rank	rank to check.
+///	\returns		true if there is a halo.
+bool MpiManager::mpi_hasHalo(int dir, int rank)
+{
+	if (dir >= L_DIMS) return false;
 
-	return;
+	int cells = static_cast<int>(std::round(
+		(rank_core_edge[2 * dir + 1][rank] - rank_core_edge[2 * dir][rank]) / L_COARSE_SITE_WIDTH));
+	return (cells != GridManager::getInstance()->global_size[dir][0]);
 }
 
 // ************************************************************************* //
@@ -207,27 +534,61 @@ void MpiManager::mpi_init()
 ///	\param	grid_man	Pointer to an initialised grid manager.
 void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 {
+	// Report a requested topology which could not be built
+	if (!topology_error.empty()) L_ERROR(topology_error, GridUtils::logfile);
+
 	// Auxiliary variables
 	cRankSizeX.resize(num_ranks);
 	cRankSizeY.resize(num_ranks);
 	cRankSizeZ.resize(num_ranks);
+
+	// Tabulate the cost of the coarse cells for fast evaluation of block costs
+#if (defined L_MPI_TOPOLOGY_REPORT || defined L_MPI_SMART_DECOMPOSE || defined L_MPI_RCB)
 	double dh = L_COARSE_SITE_WIDTH;
-	int numCells[3];
-	numCells[0] = L_N;
-	numCells[1] = L_M;
-	numCells[2] = L_K;
+	mpi_SDBuildCostTable(dh);
+#endif
 
 	// Compute block sizes based on chosen algorithm
 #ifdef L_MPI_TOPOLOGY_REPORT
 	mpi_reportOnDecomposition(dh);
+#elif defined L_MPI_RCB
+	L_INFO("Using Recursive Bisection...", GridUtils::logfile);
+	mpi_rcbDecompose(dh);
 #elif defined L_MPI_SMART_DECOMPOSE
+	// Choose free directions of the topology using the SD cost model
+	mpi_SDSelectDims(dh);
+
 	// Log use of SD
 	L_INFO("Using Smart Decomposition...", GridUtils::logfile);
 	mpi_smartDecompose(dh);
 #else
+	int numCells[3];
+	numCells[0] = L_N;
+	numCells[1] = L_M;
+	numCells[2] = L_K;
 	mpi_uniformDecompose(&numCells[0]);
 #endif
 
+	// Set local grid sizes, block edges and halo positions
+	mpi_setBlockGeometry(grid_man);
+
+#if (defined L_MPI_NODE_AWARE && !defined L_MPI_RCB)
+	// Place the blocks on the nodes so that most halo traffic stays within a node
+	if (mpi_placeRanksOnNodes(grid_man)) mpi_setBlockGeometry(grid_man);
+#endif
+
+	// Report the topology and the imbalance expected from the decomposition
+#ifdef L_MPI_RCB
+	L_INFO("Decomposition into " + std::to_string(num_ranks) + " blocks with " + 
+		std::to_string(neighbour_rank.size()) + " neighbours on this rank has a predicted imbalance of " + 
+		std::to_string(mpi_predictImbalance()) + "%.", GridUtils::logfile);
+#else
+	L_INFO("MPI topology of " + std::to_string(dimensions[eXDirection]) + "x" + 
+		std::to_string(dimensions[eYDirection]) + "x" + std::to_string(dimensions[eZDirection]) + 
+		" ranks has a predicted imbalance of " + std::to_string(mpi_predictImbalance()) + "%.", GridUtils::logfile);
+#endif
+	sd_cost_table.clear();
+
 #ifdef L_MPI_VERBOSE
 	std::string msg("Rank Sizes in the X direction = ");
 	for (int i = 0; i < num_ranks; i++) msg += std::to_string(cRankSizeX[i]) + " ";
@@ -239,50 +600,31 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 	for (int i = 0; i < num_ranks; i++) msg += std::to_string(cRankSizeZ[i]) + " ";
 	L_INFO(msg, logout); msg.clear();
 #endif
+}
 
-	// Compute required local grid size to pass to grid manager //
-	std::vector<int> local_size;
-
-	// Loop over dimensions
-	for (size_t d = 0; d < L_DIMS; d++)
-	{
-		if (dimensions[d] == 1)
-		{
-			// If only 1 rank in this direction local grid is same size a global grid (no halo)
-			local_size.push_back(grid_man->global_size[d][0]);
-
-		}
-		else
-		{
-			// Else, get grids sizes from the arrays and add halo
-			switch (d)
-			{
-			case 0:
-				local_size.push_back(cRankSizeX[my_rank] + 2);
-				break;
-			case 1:
-				local_size.push_back(cRankSizeY[my_rank] + 2);
-				break;
-			case 2:
-				local_size.push_back(cRankSizeZ[my_rank] + 2);
-				break;
-
-			default:
-				break;
-			}
-		}
-	}
-
-	// Set sizes in grid manager
-	grid_man->setLocalCoarseSize(local_size);
-
-
-	/* Only rank 0 does the assignment of rank core edges and communicates the
-	* result to the other ranks for consistency. */
+// ************************************************************************* //
+/// \brief	Block geometry construction.
+///
+///			Uses the current rank size arrays to set the edges of every rank 
+///			core (unless set directly by recursive bisection), the local grid 
+///			size in the grid manager, the positions of the sender and receiver 
+///			layers on this rank and the list of neighbour ranks. Called by the 
+///			domain decomposition and whenever the rank sizes are changed at run 
+///			time.
+///
+///	\param	grid_man	Pointer to an initialised grid manager.
+void MpiManager::mpi_setBlockGeometry(GridManager* const grid_man)
+{
+	// Coarse spacing
+	double dh = L_COARSE_SITE_WIDTH;
 
 	// Resize the rank core edge array
 	rank_core_edge.resize(6, std::vector<double>(num_ranks));
 
+	/* Only rank 0 does the assignment of rank core edges and communicates the
+	* result to the other ranks for consistency. Recursive bisection sets the 
+	* edges directly. */
+#ifndef L_MPI_RCB
 	if (my_rank == 0)
 	{
 		// Variables
@@ -346,10 +688,42 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 
 	// Communicate all the grid edges around the topology
 	mpi_communicateBlockEdges();
+#endif
 
 	// Wait for all ranks
 	MPI_Barrier(world_comm);
 
+	// Compute required local grid size to pass to grid manager //
+	std::vector<int> local_size;
+
+	// Loop over dimensions
+	for (int d = 0; d < L_DIMS; d++)
+	{
+		if (!mpi_hasHalo(d, my_rank))
+		{
+			// If block spans the domain in this direction local grid is same size a global grid (no halo)
+			local_size.push_back(grid_man->global_size[d][0]);
+
+		}
+		else
+		{
+			// Else, get grid size from the block edges and add halo
+			int cells = static_cast<int>(std::round(
+				(rank_core_edge[2 * d + 1][my_rank] - rank_core_edge[2 * d][my_rank]) / dh));
+			local_size.push_back(cells + 2 * L_MPI_HALO_DEPTH);
+
+			// A halo deeper than the block would wrap past the neighbouring block
+			if (cells < L_MPI_HALO_DEPTH)
+			{
+				L_ERROR("Block is " + std::to_string(cells) + " cells wide in direction " + std::to_string(d) + 
+					" which is less than the halo depth. Use fewer ranks or a shallower halo.", GridUtils::logfile);
+			}
+		}
+	}
+
+	// Set sizes in grid manager
+	grid_man->setLocalCoarseSize(local_size);
+
 #ifdef L_MPI_VERBOSE
 	// Write out the Grid size vector
 	*logout << "Grid size including halo on rank " << my_rank << " is (";
@@ -365,6 +739,9 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 		")", logout);
 #endif
 
+	// Halo thickness
+	double halo = L_MPI_HALO_DEPTH * dh;
+
 	/* Now update the halo regions taking into account periodicity.
 	 *
 	 * Note that if we don't want to have a halo in a given direction due to there
@@ -373,7 +750,7 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 	 * used by LUMA, i.e. < 0.0. */
 
 	// X
-	if (dimensions[eXDirection] == 1)
+	if (!mpi_hasHalo(eXDirection, my_rank))
 	{
 		sender_layer_pos.X[eLeftMin] = -1.0;
 		sender_layer_pos.X[eLeftMax] = -1.0;
@@ -387,35 +764,35 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 	else
 	{
 		sender_layer_pos.X[eLeftMin] = rank_core_edge[eXMin][my_rank];
-		sender_layer_pos.X[eLeftMax] = rank_core_edge[eXMin][my_rank] + dh;
-		sender_layer_pos.X[eRightMin] = rank_core_edge[eXMax][my_rank] - dh;
+		sender_layer_pos.X[eLeftMax] = rank_core_edge[eXMin][my_rank] + halo;
+		sender_layer_pos.X[eRightMin] = rank_core_edge[eXMax][my_rank] - halo;
 		sender_layer_pos.X[eRightMax] = rank_core_edge[eXMax][my_rank];
 
 		// Check if need to wrap or not
-		if (sender_layer_pos.X[eLeftMin] - dh < 0.0)
+		if (sender_layer_pos.X[eLeftMin] - halo < 0.0)
 		{
-			recv_layer_pos.X[eLeftMin] = grid_man->global_edges[eXMax][0] - dh;
+			recv_layer_pos.X[eLeftMin] = grid_man->global_edges[eXMax][0] - halo;
 			recv_layer_pos.X[eLeftMax] = grid_man->global_edges[eXMax][0];
 		}
 		else
 		{
-			recv_layer_pos.X[eLeftMin] = sender_layer_pos.X[eLeftMin] - dh;
+			recv_layer_pos.X[eLeftMin] = sender_layer_pos.X[eLeftMin] - halo;
 			recv_layer_pos.X[eLeftMax] = sender_layer_pos.X[eLeftMin];
 		}
-		if (sender_layer_pos.X[eRightMax] + dh > grid_man->global_edges[eXMax][0])
+		if (sender_layer_pos.X[eRightMax] + halo > grid_man->global_edges[eXMax][0])
 		{
 			recv_layer_pos.X[eRightMin] = 0.0;
-			recv_layer_pos.X[eRightMax] = dh;
+			recv_layer_pos.X[eRightMax] = halo;
 		}
 		else
 		{
 			recv_layer_pos.X[eRightMin] = sender_layer_pos.X[eRightMax];
-			recv_layer_pos.X[eRightMax] = sender_layer_pos.X[eRightMax] + dh;
+			recv_layer_pos.X[eRightMax] = sender_layer_pos.X[eRightMax] + halo;
 		}
 	}
 
 	// Y
-	if (dimensions[eYDirection] == 1)
+	if (!mpi_hasHalo(eYDirection, my_rank))
 	{
 		sender_layer_pos.Y[eLeftMin] = -1.0;
 		sender_layer_pos.Y[eLeftMax] = -1.0;
@@ -429,34 +806,34 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 	else
 	{
 		sender_layer_pos.Y[eLeftMin] = rank_core_edge[eYMin][my_rank];
-		sender_layer_pos.Y[eLeftMax] = rank_core_edge[eYMin][my_rank] + dh;
-		sender_layer_pos.Y[eRightMin] = rank_core_edge[eYMax][my_rank] - dh;
+		sender_layer_pos.Y[eLeftMax] = rank_core_edge[eYMin][my_rank] + halo;
+		sender_layer_pos.Y[eRightMin] = rank_core_edge[eYMax][my_rank] - halo;
 		sender_layer_pos.Y[eRightMax] = rank_core_edge[eYMax][my_rank];
-		if (sender_layer_pos.Y[eLeftMin] - dh < 0.0)
+		if (sender_layer_pos.Y[eLeftMin] - halo < 0.0)
 		{
-			recv_layer_pos.Y[eLeftMin] = grid_man->global_edges[eYMax][0] - dh;
+			recv_layer_pos.Y[eLeftMin] = grid_man->global_edges[eYMax][0] - halo;
 			recv_layer_pos.Y[eLeftMax] = grid_man->global_edges[eYMax][0];
 		}
 		else
 		{
-			recv_layer_pos.Y[eLeftMin] = sender_layer_pos.Y[eLeftMin] - dh;
+			recv_layer_pos.Y[eLeftMin] = sender_layer_pos.Y[eLeftMin] - halo;
 			recv_layer_pos.Y[eLeftMax] = sender_layer_pos.Y[eLeftMin];
 		}
-		if (sender_layer_pos.Y[eRightMax] + dh > grid_man->global_edges[eYMax][0])
+		if (sender_layer_pos.Y[eRightMax] + halo > grid_man->global_edges[eYMax][0])
 		{
 			recv_layer_pos.Y[eRightMin] = 0.0;
-			recv_layer_pos.Y[eRightMax] = dh;
+			recv_layer_pos.Y[eRightMax] = halo;
 		}
 		else
 		{
 			recv_layer_pos.Y[eRightMin] = sender_layer_pos.Y[eRightMax];
-			recv_layer_pos.Y[eRightMax] = sender_layer_pos.Y[eRightMax] + dh;
+			recv_layer_pos.Y[eRightMax] = sender_layer_pos.Y[eRightMax] + halo;
 		}
 	}
 
 	// Z
 #if (L_DIMS == 3)
-	if (dimensions[eZDirection] == 1)
+	if (!mpi_hasHalo(eZDirection, my_rank))
 	{
 		sender_layer_pos.Z[eLeftMin] = -1.0;
 		sender_layer_pos.Z[eLeftMax] = -1.0;
@@ -470,39 +847,39 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 	else
 	{
 		sender_layer_pos.Z[eLeftMin] = rank_core_edge[eZMin][my_rank];
-		sender_layer_pos.Z[eLeftMax] = rank_core_edge[eZMin][my_rank] + dh;
-		sender_layer_pos.Z[eRightMin] = rank_core_edge[eZMax][my_rank] - dh;
+		sender_layer_pos.Z[eLeftMax] = rank_core_edge[eZMin][my_rank] + halo;
+		sender_layer_pos.Z[eRightMin] = rank_core_edge[eZMax][my_rank] - halo;
 		sender_layer_pos.Z[eRightMax] = rank_core_edge[eZMax][my_rank];
-		if (sender_layer_pos.Z[eLeftMin] - dh < 0.0)
+		if (sender_layer_pos.Z[eLeftMin] - halo < 0.0)
 		{
-			recv_layer_pos.Z[eLeftMin] = grid_man->global_edges[eZMax][0] - dh;
+			recv_layer_pos.Z[eLeftMin] = grid_man->global_edges[eZMax][0] - halo;
 			recv_layer_pos.Z[eLeftMax] = grid_man->global_edges[eZMax][0];
 		}
 		else
 		{
-			recv_layer_pos.Z[eLeftMin] = sender_layer_pos.Z[eLeftMin] - dh;
+			recv_layer_pos.Z[eLeftMin] = sender_layer_pos.Z[eLeftMin] - halo;
 			recv_layer_pos.Z[eLeftMax] = sender_layer_pos.Z[eLeftMin];
 		}
-		if (sender_layer_pos.Z[eRightMax] + dh > grid_man->global_edges[eZMax][0])
+		if (sender_layer_pos.Z[eRightMax] + halo > grid_man->global_edges[eZMax][0])
 		{
 			recv_layer_pos.Z[eRightMin] = 0.0;
-			recv_layer_pos.Z[eRightMax] = dh;
+			recv_layer_pos.Z[eRightMax] = halo;
 		}
 		else
 		{
 			recv_layer_pos.Z[eRightMin] = sender_layer_pos.Z[eRightMax];
-			recv_layer_pos.Z[eRightMax] = sender_layer_pos.Z[eRightMax] + dh;
+			recv_layer_pos.Z[eRightMax] = sender_layer_pos.Z[eRightMax] + halo;
 		}
 }
 #endif
 
 #ifdef L_MPI_VERBOSE
-	if (dimensions[eXDirection] == 1 || dimensions[eYDirection] == 1
+	if (!mpi_hasHalo(eXDirection, my_rank) || !mpi_hasHalo(eYDirection, my_rank)
 #if (L_DIMS == 3)
-		|| dimensions[eZDirection] == 1
+		|| !mpi_hasHalo(eZDirection, my_rank)
 #endif
 		)
-		L_WARN("One of the MPI dimensions is 1 so sender and receiver layers in this direction will be set to -1 as they have no meaning in this context.", logout);
+		L_WARN("Block spans the domain in one direction so sender and receiver layers in this direction will be set to -1 as they have no meaning in this context.", logout);
 
 	L_INFO("X sender layers are: " +
 		std::to_string(sender_layer_pos.X[eLeftMin]) + " -- " + std::to_string(sender_layer_pos.X[eLeftMax]) + " (min edge) , " +
@@ -534,6 +911,8 @@ void MpiManager::mpi_gridbuild(GridManager* const grid_man)
 #endif
 #endif
 
+	// Find the ranks which share halo data with this one
+	mpi_setNeighbours();
 }
 
 
@@ -578,19 +957,19 @@ void MpiManager::mpi_communicateBlockEdges()
 ///
 ///			When verbose MPI logging is turned on this method will write out 
 ///			the communication buffer to an ASCII file.
-void MpiManager::mpi_writeout_buf( std::string filename, int dir ) {
+void MpiManager::mpi_writeout_buf( std::string filename, int nbr ) {
 
 	std::ofstream rankout;
 	rankout.open(filename.c_str(), std::ios::out);
 
-	rankout << "f_buffer_send is of size " << f_buffer_send[dir].size() << " with values: " << std::endl;
-	for (size_t v = 0; v < f_buffer_send[dir].size(); v++) {
-		rankout << f_buffer_send[dir][v] << std::endl;
+	rankout << "f_buffer_send is of size " << f_buffer_send[nbr].size() << " with values: " << std::endl;
+	for (size_t v = 0; v < f_buffer_send[nbr].size(); v++) {
+		rankout << f_buffer_send[nbr][v] << std::endl;
 	}
 
-	rankout << "f_buffer_recv is of size " << f_buffer_recv[dir].size() << " with values: " << std::endl;
-	for (size_t v = 0; v < f_buffer_recv[dir].size(); v++) {
-		rankout << f_buffer_recv[dir][v] << std::endl;
+	rankout << "f_buffer_recv is of size " << f_buffer_recv[nbr].size() << " with values: " << std::endl;
+	for (size_t v = 0; v < f_buffer_recv[nbr].size(); v++) {
+		rankout << f_buffer_recv[nbr][v] << std::endl;
 	}
 
 	rankout.close();
@@ -601,14 +980,18 @@ void MpiManager::mpi_writeout_buf( std::string filename, int dir ) {
 // ************************************************************************* //
 /// \brief	Communication routine.
 ///
-///			This method implements the communication between grids of the same
-///			level and region across MPI processes. Each call effects
-///			communication in all valid directions for the grid of the supplied
-///			level and region.
+///			This method implements the communication between grids across MPI 
+///			processes. Each call queues the halo exchange of the grid of the 
+///			supplied level and region. A grid finishing its last sub-cycle 
+///			does not need its halo again until its parent has stepped, so its 
+///			exchange is held back and sent with the parent's. Otherwise every
+///			queued exchange is sent, with one message per neighbour carrying 
+///			the sites of all the queued grids.
 ///
-/// \param	lev	level of grid to communicate.
-/// \param	reg	region number of grid to communicate.
-void MpiManager::mpi_communicate(int lev, int reg) {
+/// \param	lev			level of grid to communicate.
+/// \param	reg			region number of grid to communicate.
+/// \param	subcycle	sub-cycle just completed by the grid.
+void MpiManager::mpi_communicate(int lev, int reg, int subcycle) {
 
 	// Wall clock variables
 	clock_t t_start, t_end, secs;
@@ -621,6 +1004,36 @@ void MpiManager::mpi_communicate(int lev, int reg) {
 	GridObj* Grid = NULL;
 	GridUtils::getGrid(GridManager::getInstance()->Grids, lev, reg,  Grid);
 
+	// Start the clock
+	t_start = clock();
+
+	// Deep halos let the grid take several steps between exchanges
+	if (Grid->t % halo_exchange_interval[Grid->level] == 0)
+	{
+		ExchangeGridStruct ex;
+		ex.grid = Grid;
+		for (size_t b = 0; b < buffer_send_info.size(); b++) {
+			if (buffer_send_info[b].level == Grid->level && buffer_send_info[b].region == Grid->region_number) ex.info = b;
+		}
+		exchange_queue.push_back(ex);
+	}
+
+	// Hold back the exchange after the last sub-cycle until the parent exchanges
+	if (lev > 0 && subcycle == 1) return;
+
+	// Send this grid together with the held back exchanges of its sub-grids
+	std::vector<ExchangeGridStruct> batch;
+	for (auto it = exchange_queue.begin(); it != exchange_queue.end(); )
+	{
+		if (it->grid == Grid || (it->grid->level > lev && (lev == 0 || it->grid->region_number == reg)))
+		{
+			batch.push_back(*it);
+			it = exchange_queue.erase(it);
+		}
+		else ++it;
+	}
+	if (batch.empty()) return;
+
 
 	///////////////////////
 	// MPI Communication //
@@ -637,124 +1050,146 @@ void MpiManager::mpi_communicate(int lev, int reg) {
 	* will be out of sync. Need to allow the blocking nature of the send and receive calls to force correct 
 	* synchronisation between processes and only call barriers outside the grid scope.
 	*
-	* For each sending direction, pack and load a message into the message queue 
-	* for the destination rank with tag associated with direction.
-	* Then for each receive direction, pull message with correct tag from the queue 
+	* For each neighbouring rank, pack and load a message into the message queue 
+	* for the destination rank with tag associated with the grid.
+	* Then for each neighbouring rank, pull message with correct tag from the queue 
 	* and unpack.
 	*
 	* In order to do this, need non-blocking send and receive calls and each needs
 	* their own buffer to store the information which cannot be touched until the 
 	* send is completed, hence this implementation carries a bigger memeory requirement
-	* as buffer reuse through the direction loop is not possible.
+	* as buffer reuse through the neighbour loop is not possible.
 	* Although MPI_Bsend() will do something similar it relies on creating and filling 
 	* MPI background buffers which might have limited resources and which is slower so 
-	* we use the MPI Manager class to hold the buffer in house. */
-
-	// Start the clock
-	t_start = clock();
+	* we use the MPI Manager class to hold the buffer in house. 
+	*
+	* Exchanges are held back by the structure of the grid hierarchy alone so 
+	* both ranks of a pair send the same grids together. Each grid's sites sit at
+	* an offset in the message given by the sizes of the grids before it. */
 
-	// Loop over directions in Cartesian topology
-	for (int dir = 0; dir < L_MPI_DIRS; dir++)
+	// Offsets of each queued grid in the buffers of each neighbour
+	std::vector<size_t> send_size(neighbour_rank.size(), 0), recv_size(neighbour_rank.size(), 0);
+	for (ExchangeGridStruct& ex : batch)
 	{
+		ex.send_offset.resize(neighbour_rank.size());
+		ex.recv_offset.resize(neighbour_rank.size());
+		for (size_t n = 0; n < neighbour_rank.size(); n++)
+		{
+			ex.send_offset[n] = send_size[n];
+			ex.recv_offset[n] = recv_size[n];
+			send_size[n] += mpi_bufferWords(ex.grid->level, buffer_send_info[ex.info].sites[n].size());
+			recv_size[n] += mpi_bufferWords(ex.grid->level, buffer_recv_info[ex.info].sites[n].size());
+		}
+	}
 
-		/* Create a unique tag based on level (< 32), region (< 10) and direction (< 100).
-		 * MPICH limits state that tag value cannot be greater than 32767 */
-		TAG = ((Grid->level + 1) * 1000) + ((Grid->region_number + 1) * 100) + dir;
+	/* Create a unique tag based on level (< 32) and region (< 10) of the grid 
+	 * which sends the queue. MPICH limits state that tag value cannot be greater 
+	 * than 32767 */
+	TAG = ((Grid->level + 1) * 1000) + ((Grid->region_number + 1) * 100);
 
 #ifdef L_MPI_VERBOSE
-		*logout << "Processing Message with Tag --> " << TAG << std::endl;
+	*logout << "Processing Messages with Tag --> " << TAG << std::endl;
 #endif
 
-		////////////////////////////
-		// Resize and Pack Buffer //
-		////////////////////////////
+	/* Face exchanges take one stage per direction. Each stage must be 
+	 * unpacked before the next is packed so that edge and corner sites 
+	 * received in one stage are forwarded in the next. */
+#ifdef L_MPI_FACE_EXCHANGE
+	const int numStages = L_DIMS;
+#else
+	const int numStages = 1;
+#endif
+	for (int stage = 0; stage < numStages; stage++)
+	{
 
-		// Adjust buffer size
-		for (MpiManager::BufferSizeStruct bufs : buffer_send_info) {
-			if (bufs.level == Grid->level && bufs.region == Grid->region_number) {
-				f_buffer_send[dir].resize(bufs.size[dir] * L_NUM_VELS);
-			}
-		}
+		// Loop over neighbours in this stage posting sends
+		for (size_t n = 0; n < neighbour_rank.size(); n++)
+		{
+			if (neighbour_stage[n] != stage) continue;
 
-		// Only pack and send if required
-		if (f_buffer_send[dir].size()) {
+			////////////////////////////
+			// Resize and Pack Buffer //
+			////////////////////////////
 
-			// Pass direction and Grid by reference and pack if required
-			mpi_buffer_pack( dir, Grid );
-		
+			// Adjust buffer size
+			f_buffer_send[n].resize(send_size[n]);
 
-			///////////////
-			// Post Send //
-			///////////////
+			// Only pack and send if required
+			if (f_buffer_send[n].size()) {
 
-			send_count++;
+				// Pack the sites of each queued grid at its offset
+				for (ExchangeGridStruct& ex : batch)
+					mpi_buffer_pack( static_cast<int>(n), ex.grid, ex.send_offset[n] );
+		
 
-#ifdef L_MPI_VERBOSE
-			*logout << "L" << Grid->level << "R" << Grid->region_number << " -- Direction " << dir 
-								<< " -->  Posting Send for " << f_buffer_send[dir].size() / L_NUM_VELS
-								<< " sites to Rank " << neighbour_rank[dir] << " with tag " << TAG << "." << std::endl;
-#endif
-			// Post send message to message queue and log request handle in array
-			MPI_Isend( &f_buffer_send[dir].front(), static_cast<int>(f_buffer_send[dir].size()), MPI_DOUBLE, neighbour_rank[dir], 
-				TAG, world_comm, &send_requests[send_count-1] );
+				///////////////
+				// Post Send //
+				///////////////
+
+				send_count++;
 
 #ifdef L_MPI_VERBOSE
-			*logout << "Direction " << dir << " --> Send Posted." << std::endl;
+				*logout << "L" << Grid->level << "R" << Grid->region_number << " -- Neighbour " << n 
+									<< " -->  Posting Send for " << f_buffer_send[n].size()
+									<< " words to Rank " << neighbour_rank[n] << " with tag " << TAG << "." << std::endl;
 #endif
+				// Post send message to message queue and log request handle in array
+				MPI_Isend( &f_buffer_send[n].front(), static_cast<int>(f_buffer_send[n].size()), MPI_DOUBLE, neighbour_rank[n], 
+					TAG, world_comm, &send_requests[send_count-1] );
 
-		}
-
-		// Find opposite direction (neighbour it receives from)
-		int opp_dir = mpi_getOpposite(dir);
-		
-		// Resize the receive buffer
-		for (MpiManager::BufferSizeStruct bufr : buffer_recv_info) {
-			if (bufr.level == Grid->level && bufr.region == Grid->region_number) {
-				f_buffer_recv[dir].resize(bufr.size[dir] * L_NUM_VELS);
 			}
 		}
 
+		// Loop over neighbours in this stage fetching messages
+		for (size_t n = 0; n < neighbour_rank.size(); n++)
+		{
+			if (neighbour_stage[n] != stage) continue;
+			// Resize the receive buffer
+			f_buffer_recv[n].resize(recv_size[n]);
 
-		///////////////////
-		// Fetch Message //
-		///////////////////
 
-		if (f_buffer_recv[dir].size()) {
+			///////////////////
+			// Fetch Message //
+			///////////////////
+
+			if (f_buffer_recv[n].size()) {
 
 #ifdef L_MPI_VERBOSE
-			*logout << "L" << Grid->level << "R" << Grid->region_number << " -- Direction " << dir 
-								<< " -->  Fetching message for " << f_buffer_recv[dir].size() / L_NUM_VELS	
-								<< " sites from Rank " << neighbour_rank[opp_dir] << " with tag " << TAG << "." << std::endl;
+				*logout << "L" << Grid->level << "R" << Grid->region_number << " -- Neighbour " << n 
+									<< " -->  Fetching message for " << f_buffer_recv[n].size()
+									<< " words from Rank " << neighbour_rank[n] << " with tag " << TAG << "." << std::endl;
 #endif
 
-			// Use a blocking receive call if required
-			MPI_Recv( &f_buffer_recv[dir].front(), static_cast<int>(f_buffer_recv[dir].size()), MPI_DOUBLE, neighbour_rank[opp_dir], 
-				TAG, world_comm, &recv_stat );
+				// Use a blocking receive call if required
+				MPI_Recv( &f_buffer_recv[n].front(), static_cast<int>(f_buffer_recv[n].size()), MPI_DOUBLE, neighbour_rank[n], 
+					TAG, world_comm, &recv_stat );
 
 #ifdef L_MPI_VERBOSE
-			*logout << "Direction " << dir << " --> Received." << std::endl;
+				*logout << "Neighbour " << n << " --> Received." << std::endl;
 #endif
 
-			///////////////////////////
-			// Unpack Buffer to Grid //
-			///////////////////////////
+				///////////////////////////
+				// Unpack Buffer to Grid //
+				///////////////////////////
 
-			// Pass direction and Grid by reference
-			mpi_buffer_unpack( dir, Grid );
+				// Unpack the sites of each queued grid from its offset
+				for (ExchangeGridStruct& ex : batch)
+					mpi_buffer_unpack( static_cast<int>(n), ex.grid, ex.recv_offset[n] );
 
-		}
+			}
 
 #ifdef L_MPI_VERBOSE
 
-		*logout << "SUMMARY for L" << Grid->level << "R" << Grid->region_number << " -- Direction " << dir
-			<< " -- Sent " << f_buffer_send[dir].size() / L_NUM_VELS << " to " << neighbour_rank[dir]
-			<< ": Received " << f_buffer_recv[dir].size() / L_NUM_VELS << " from " << neighbour_rank[opp_dir] << std::endl;
+			*logout << "SUMMARY for L" << Grid->level << "R" << Grid->region_number << " -- Neighbour " << n
+				<< " -- Sent " << f_buffer_send[n].size() << " words to " << neighbour_rank[n]
+				<< ": Received " << f_buffer_recv[n].size() << " words from " << neighbour_rank[n] << std::endl;
 
-		// Write out buffers
-		std::string filename = GridUtils::path_str + "/mpiBuffer_Rank" + std::to_string(my_rank) + "_Dir" + std::to_string(dir) + ".out";
-		mpi_writeout_buf(filename, dir);
+			// Write out buffers
+			std::string filename = GridUtils::path_str + "/mpiBuffer_Rank" + std::to_string(my_rank) + "_Nbr" + std::to_string(neighbour_rank[n]) + ".out";
+			mpi_writeout_buf(filename, static_cast<int>(n));
 #endif
 
+		}
 	}
 
 #ifdef L_MPI_VERBOSE
@@ -766,7 +1201,7 @@ void MpiManager::mpi_communicate(int lev, int reg) {
 	/* Wait until other processes have handled all the sends from this rank
 	 * Note that calls to this command destroy the handles once complete so
 	 * do not need to clear the array afterward. */
-	MPI_Waitall(send_count,send_requests,send_stat);
+	MPI_Waitall(send_count, send_requests.data(), send_stat.data());
 
 
 	// Print Time of MPI comms
@@ -794,22 +1229,152 @@ void MpiManager::mpi_communicate(int lev, int reg) {
 
 }
 
+// ************************************************************************* //
+/// \brief	Report the wait avoided by the barrier-free time loop.
+///
+///			The time stepping loop does not synchronise the ranks so each rank 
+///			only waits for its neighbours in the halo exchange. Had every time
+///			step ended with a barrier, each rank would have idled for at least 
+///			the difference between its compute time and that of the heaviest 
+///			rank. The compute times since the last report are reduced to the 
+///			master rank without blocking and the result is logged at the next 
+///			call, by which time the reduction has long completed.
+void MpiManager::mpi_reportWaitSaved()
+{
+	// Log the previous interval
+	mpi_completeWaitReport();
+
+	// Post the reductions for this interval
+	wait_report_send = step_compute_time;
+	wait_report_steps = step_count;
+	step_compute_time = 0.0;
+	step_count = 0;
+	MPI_Ireduce(&wait_report_send, &wait_report_recv[0], 1, MPI_DOUBLE, MPI_MAX, 0, world_comm, &wait_report_requests[0]);
+	MPI_Ireduce(&wait_report_send, &wait_report_recv[1], 1, MPI_DOUBLE, MPI_SUM, 0, world_comm, &wait_report_requests[1]);
+}
+
+// ************************************************************************* //
+/// \brief	Complete and log any outstanding wait report.
+///
+///			Time spent waiting for the reduction is added to the diagnostics 
+///			wait time.
+void MpiManager::mpi_completeWaitReport()
+{
+	if (wait_report_requests[0] == MPI_REQUEST_NULL) return;
+
+	// Complete the reductions
+	clock_t t_start = clock();
+	MPI_Waitall(2, wait_report_requests, MPI_STATUSES_IGNORE);
+	diagnostics_wait_time += static_cast<double>(clock() - t_start) / CLOCKS_PER_SEC;
+
+	if (my_rank == 0 && wait_report_steps > 0)
+	{
+		double maxTime = wait_report_recv[0] * 1000;
+		double meanTime = wait_report_recv[1] * 1000 / num_ranks;
+		L_INFO("Over the last " + std::to_string(wait_report_steps) + " time steps the heaviest rank computed for " + 
+			std::to_string(maxTime) + "ms against a mean of " + std::to_string(meanTime) + 
+			"ms. Not synchronising every time step avoided at least " + std::to_string(maxTime - meanTime) + 
+			"ms of waiting per rank.", GridUtils::logfile);
+	}
+}
+
+// ************************************************************************* //
+/// \brief	Decide how many time steps each level takes between halo exchanges.
+///
+///			A halo L_MPI_HALO_DEPTH coarse cells deep holds L_MPI_HALO_DEPTH * 2^l 
+///			sites of level l. Each step without an exchange leaves one more 
+///			site at the outside of the halo stale, so a level may take that 
+///			many steps before the stale sites reach the core. The halo sites 
+///			are updated by the kernel in the meantime, redundantly computing 
+///			what the neighbour computes on its core. IB forces are only spread
+///			to core sites so levels with IB bodies must exchange every step.
+///			The intervals are taken from the definitions, one per level, and 
+///			must agree on all ranks. Only the inner layers of the halo that are 
+///			read before the next exchange are sent, which is one layer per step 
+///			of the interval or the layers beneath those sent by the parent if 
+///			that is more.
+///			Levels may also be set to send their halo in single precision.
+///			Call after the objects have been built and before the buffers are 
+///			sized.
+void MpiManager::mpi_setExchangeIntervals()
+{
+	ObjectManager *objMan = ObjectManager::getInstance();
+	if (L_MPI_HALO_DEPTH < 1)
+	{
+		L_ERROR("Halo depth must be at least 1 coarse cell.", GridUtils::logfile);
+	}
+
+	for (int lev = 0; lev <= L_NUM_LEVELS; ++lev)
+	{
+		// Levels missing from the initialiser are zero so are caught here
+		int interval = cMpiExchangeInterval[lev];
+		int maxInterval = L_MPI_HALO_DEPTH * (1 << lev);
+		if (interval < 1 || interval > maxInterval)
+		{
+			L_ERROR("Halo exchange interval on level " + std::to_string(lev) + " is " + std::to_string(interval) + 
+				" but must be between 1 and " + std::to_string(maxInterval) + " for a halo depth of " + 
+				std::to_string(L_MPI_HALO_DEPTH) + ". Set it in cMpiExchangeInterval.", GridUtils::logfile);
+		}
+
+		// Bodies might only be known to some ranks
+		int hasIBM = (objMan->hasIBMBodies[lev] ? 1 : 0);
+		MPI_Allreduce(MPI_IN_PLACE, &hasIBM, 1, MPI_INT, MPI_MAX, world_comm);
+		if (hasIBM && interval > 1)
+		{
+			L_WARN("Level " + std::to_string(lev) + " has IB bodies so will exchange its halo every time step.", GridUtils::logfile);
+			interval = 1;
+		}
+
+		halo_exchange_interval[lev] = interval;
+
+		/* The stencil reaches one cell so each step spoils one layer of the halo 
+		 * and only that many layers need sending. The parent coalesces its halo 
+		 * layers from the two beneath each so these must be sent too. IB support 
+		 * may reach further into the halo so those levels send all of it. */
+		int depth = interval;
+		if (lev > 0) depth = std::max(depth, 2 * halo_exchange_depth[lev - 1]);
+		halo_exchange_depth[lev] = (hasIBM ? maxInterval : std::min(depth, maxInterval));
+		if (interval > 1)
+		{
+			L_INFO("Level " + std::to_string(lev) + " exchanges its halo every " + std::to_string(interval) + " time steps.", GridUtils::logfile);
+		}
+
+		halo_single_precision[lev] = (cMpiSinglePrecisionHalo[lev] != 0);
+		if (halo_single_precision[lev])
+		{
+			L_INFO("Level " + std::to_string(lev) + " sends its halo in single precision.", GridUtils::logfile);
+		}
+	}
+}
+
 // ************************************************************************* //
 /// \brief	Pre-calcualtion of the buffer sizes.
 ///
-///			Wrapper method for computing the buffer sizes for every grid on the
-///			rank, both sender and receiver. Must be called post-initialisation.
+///			Wrapper method for computing the buffer site lists for every grid 
+///			on the rank, both sender and receiver. Each rank works out which of
+///			its halo sites are owned by which neighbour and then sends the
+///			requests to the owners who build the matching send lists.
+///			Must be called post-initialisation.
 void MpiManager::mpi_buffer_size() {
 
 	*GridUtils::logfile << "Pre-computing buffer sizes for MPI...";
 
-	/* For each grid in the hierarchy find communicating edges and store the buffer size.
+	/* For each grid in the hierarchy find the halo sites and store them.
 	 * The data are arranged:
 	 *
-	 *		BufSize[direction][level][region]
+	 *		Sites[grid][neighbour][site]
 	 *
-	 * where direction is identified by the MPI labelling at the top of this file.
-	 * A zero buffer size indicates that this edge does not communicate with a neighbour rank. */
+	 * where neighbour is the index into the neighbour rank list.
+	 * An empty list indicates that this grid does not communicate with that neighbour. */
+
+	// Clear any existing site lists
+	buffer_send_info.clear();
+	buffer_recv_info.clear();
+
+	// Site requests to send to each neighbour (level, region, global index)
+	size_t numNeighbours = neighbour_rank.size();
+	std::vector<std::vector<int>> requestsOut(numNeighbours);
+	std::vector<std::vector<int>> requestsIn(numNeighbours);
 
 	// Loop through levels and regions
 	GridObj* g;	// Pointer to a GridObj
@@ -829,170 +1394,121 @@ void MpiManager::mpi_buffer_size() {
 			}
 
 			// Expand buffer info arrays by one and add grid ID info
-			buffer_send_info.emplace_back(l, r);
-			buffer_recv_info.emplace_back(l, r);
-
-			/* Not every edge of a grid needs to be communicated.
-			 * We therefore loop over the appropriate region of the grid and 
-			 * check whether a site lies in the associated sender / receiver 
-			 * layer. If so increment the buffer size counter. */
-
-			// Call send and recv size finding routines
-			mpi_buffer_size_send(g);
-			mpi_buffer_size_recv(g);
-
-
-#ifdef L_MPI_VERBOSE
-			// Write out buffer sizes for reference
-			*logout << "Send buffer sizes are [L" << buffer_send_info.back().level << ",R" << buffer_send_info.back().region << "]" << '\t';
-			for (int i = 0; i < L_MPI_DIRS; i++) {
-				*logout << buffer_send_info.back().size[i] << '\t';
-			}
-			*logout << std::endl;
-
-			*logout << "Recv buffer sizes are [L" << buffer_recv_info.back().level << ",R" << buffer_recv_info.back().region << "]" << '\t';
-			for (int i = 0; i < L_MPI_DIRS; i++) {
-				*logout << buffer_recv_info.back().size[i] << '\t';
-			}
-			*logout << std::endl;
-#endif
-
+			buffer_send_info.emplace_back(l, r, numNeighbours);
+			buffer_recv_info.emplace_back(l, r, numNeighbours);
 
+			// Find the receiver sites and who owns them
+			mpi_buffer_size_recv(g, requestsOut);
 		}
 	}
 
-	*GridUtils::logfile << "Complete." << std::endl;
-
-#ifdef L_MPI_VERBOSE
-	/* Historically, there have been cases of MPI hangs due to buffer
-	* size inconsistencies between ranks. These are difficult to debug
-	* as it involves going through the log files and cross checking
-	* each send and receive by hand. To speed up the process we
-	* implement a debugging activity here to check the send and receive
-	* buffer sizes tally up across the topology. */
-	int * const bufSendSizesOut = new int[L_NUM_LEVELS * L_NUM_REGIONS + 1];
-	int * const bufSendSizesIn = new int[L_NUM_LEVELS * L_NUM_REGIONS + 1];
-	bool bInfoFound = false;
-
-	// Loop over the MPI directions
-	for (int i = 0; i < L_MPI_DIRS; i++)
-	{
-		int counter = 0;
-
-		// Loop over grids and sub-grids and pack buffer one at a time
-		for (int l = 0; l <= L_NUM_LEVELS; l++)
-		{
-			for (int r = 0; r < L_NUM_REGIONS; r++)
-			{
-				bInfoFound = false;
-				if (l == 0 && r != 0) continue;		// L0 can only be R0
+	// Swap the number of requested sites with each neighbour
+	std::vector<int> countOut(numNeighbours), countIn(numNeighbours);
+	std::vector<MPI_Request> reqs(2 * numNeighbours);
+	for (size_t n = 0; n < numNeighbours; n++)
+	{
+		countOut[n] = static_cast<int>(requestsOut[n].size());
+		MPI_Irecv(&countIn[n], 1, MPI_INT, neighbour_rank[n], 0, world_comm, &reqs[2 * n]);
+		MPI_Isend(&countOut[n], 1, MPI_INT, neighbour_rank[n], 0, world_comm, &reqs[2 * n + 1]);
+	}
+	MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
 
-				// Try retireve the buffer size info
-				for (MpiManager::BufferSizeStruct bufs : buffer_send_info)
-				{
-					if (bufs.level == l && bufs.region == r)
-					{
-						bufSendSizesOut[counter] = bufs.size[i];
-						bInfoFound = true;
-					}
-				}
+	// Swap the requests themselves
+	int nReqs = 0;
+	for (size_t n = 0; n < numNeighbours; n++)
+	{
+		requestsIn[n].resize(countIn[n]);
+		if (countIn[n]) MPI_Irecv(requestsIn[n].data(), countIn[n], MPI_INT, neighbour_rank[n], 1, world_comm, &reqs[nReqs++]);
+		if (countOut[n]) MPI_Isend(requestsOut[n].data(), countOut[n], MPI_INT, neighbour_rank[n], 1, world_comm, &reqs[nReqs++]);
+	}
+	MPI_Waitall(nReqs, reqs.data(), MPI_STATUSES_IGNORE);
 
-				// If no info found then grid doesn't exist on this rank so mark as zero
-				if (!bInfoFound) bufSendSizesOut[counter] = 0;
+	// Build the sender site lists from the requests
+	for (size_t b = 0; b < buffer_send_info.size(); b++)
+	{
+		GridUtils::getGrid(GridManager::getInstance()->Grids, buffer_send_info[b].level, buffer_send_info[b].region, g);
+		mpi_buffer_size_send(g, requestsIn);
 
-				// Increment counter
-				counter++;
-			}
+#ifdef L_MPI_VERBOSE
+		// Write out buffer sizes for reference
+		*logout << "Send buffer sizes are [L" << buffer_send_info[b].level << ",R" << buffer_send_info[b].region << "]" << '\t';
+		for (size_t n = 0; n < numNeighbours; n++) {
+			*logout << buffer_send_info[b].sites[n].size() << '\t';
 		}
+		*logout << std::endl;
 
-		L_INFO("Send sizes packed for direction " + std::to_string(i) + ". Sending to rank " + std::to_string(neighbour_rank[i]) + "...", logout);
-
-		// Once buffer complete, post send
-		MPI_Isend(bufSendSizesOut, L_NUM_LEVELS * L_NUM_REGIONS + 1, MPI_INT, neighbour_rank[i],
-			my_rank, world_comm, &send_requests[i]);
-
-		L_INFO("Sent.", logout);
-
-		// Get opposite direction
-		int opp_i = mpi_getOpposite(i);
-		L_INFO("Receiving send sizes from rank " + std::to_string(neighbour_rank[opp_i]) + " in direction " + std::to_string(opp_i) + "...", logout);
-
-		// Receive the send sizes from opposite direction
-		MPI_Recv(bufSendSizesIn, L_NUM_LEVELS * L_NUM_REGIONS + 1, MPI_INT, neighbour_rank[opp_i],
-			neighbour_rank[opp_i], world_comm, &recv_stat);
-
-		L_INFO("Received.", logout);
-
-		// Cross check that the send sizes match the receive sizes
-		counter = 0;
-		// Loop over grids and sub-grids and unpack buffer one at a time
-		for (int l = 0; l <= L_NUM_LEVELS; l++)
-		{
-			for (int r = 0; r < L_NUM_REGIONS; r++)
-			{
-				bInfoFound = false;
-				if (l == 0 && r != 0) continue;		// L0 can only be R0
-
-				// Try retireve the buffer size info
-				for (MpiManager::BufferSizeStruct bufr : buffer_recv_info)
-				{
-					if (bufr.level == l && bufr.region == r)
-					{
-						bInfoFound = true;
-						if (bufSendSizesIn[counter] != bufr.size[i])
-						{
-							L_ERROR("L" + std::to_string(l) + "R" + std::to_string(r) + 
-								" -- Mismatch in buffer sizes! Rank " + std::to_string(neighbour_rank[opp_i]) +
-								" is sending " + std::to_string(bufSendSizesIn[counter]) + 
-								". Expected to receive " + std::to_string(bufr.size[i]), GridUtils::logfile);
-						}						
-					}
-				}
-
-				// If no info found then grid doesn't exist on this rank -- make sure buffer size is zero
-				if (!bInfoFound)
-				{
-					if (bufSendSizesIn[counter] != 0)
-					{
-						L_ERROR("L" + std::to_string(l) + "R" + std::to_string(r) + 
-							" -- Mismatch in buffer sizes! Rank " + std::to_string(neighbour_rank[opp_i]) +
-							" is sending " + std::to_string(bufSendSizesIn[counter]) +
-							". Expected to receive 0 as no grid of this L+R on this rank.", GridUtils::logfile);
-					}
-				}
+		*logout << "Recv buffer sizes are [L" << buffer_recv_info[b].level << ",R" << buffer_recv_info[b].region << "]" << '\t';
+		for (size_t n = 0; n < numNeighbours; n++) {
+			*logout << buffer_recv_info[b].sites[n].size() << '\t';
+		}
+		*logout << std::endl;
+#endif
+	}
 
-				// Increment counter
-				counter++;
-			}
-		}		
+	// Every request must be matched by a grid on this rank or the neighbour will hang
+	for (size_t n = 0; n < numNeighbours; n++)
+	{
+		size_t matched = 0;
+		for (size_t b = 0; b < buffer_send_info.size(); b++) matched += buffer_send_info[b].sites[n].size();
+		if (matched * 5 != requestsIn[n].size())
+		{
+			L_ERROR("Rank " + std::to_string(neighbour_rank[n]) + " requested sites on a grid which does not exist on this rank. Exiting.", 
+				GridUtils::logfile);
+		}
 	}
-	delete[] bufSendSizesOut;
-	delete[] bufSendSizesIn;
 
-#endif
+	*GridUtils::logfile << "Complete." << std::endl;
+
+	// Report how much of the exchange leaves the node
+	mpi_reportNodeTraffic();
 
 }
 
 // ************************************************************************* //
-/// \brief	Helper method to find opposite direction in MPI topology.
+/// \brief	Size of the halo data of a level in the communication buffers.
 ///
-///			The MPI directional vectors do not necessarily correspond to the 
-///			lattice model direction. The MPI directional vectors are defined 
-///			separately and hence there is a separate opposite finding method.
+///			Buffers are held as doubles. Levels sending their halo in single
+///			precision pack two populations into each buffer word.
 ///
-/// \param	direction	the outgoing direction whose opposite you wish to find.
-int MpiManager::mpi_getOpposite(int direction) {
-
-	/*	If direction is even, then opposite is direction+1.
-		If direction is odd, then opposite is direction-1.
-		e.g. direction 0 (+x direction) has opposite 1 (-x direction) --> +1
-		however, direction 1 has opposite 0 --> -1
-		Hence we can add (-1 ^ direction) so it alternates between +/-1
-	*/
+///	\param	level	level of the grid being exchanged.
+///	\param	sites	number of sites exchanged.
+///	\returns	number of buffer words taken by the sites.
+size_t MpiManager::mpi_bufferWords(int level, size_t sites)
+{
+	size_t values = sites * L_NUM_VELS;
+	return (halo_single_precision[level] ? (values + 1) / 2 : values);
+}
 
-		return direction + (int)pow(-1,direction);
+// ************************************************************************* //
+/// \brief	Report the halo data sent within and between nodes.
+///
+///			The data sent by every rank in one coarse time step, accounting for 
+///			the sub-cycles and exchange interval of each level, are summed over 
+///			the neighbours on the same node and on other nodes and the totals 
+///			written to the log. Called by all ranks.
+void MpiManager::mpi_reportNodeTraffic()
+{
+	// Bytes sent in a coarse time step [within node, between nodes]
+	double traffic[2] = { 0.0, 0.0 };
+	for (size_t b = 0; b < buffer_send_info.size(); b++)
+	{
+		int level = buffer_send_info[b].level;
+		double exchanges = static_cast<double>(1 << level) / halo_exchange_interval[level];
+		for (size_t n = 0; n < neighbour_rank.size(); n++)
+		{
+			double bytes = exchanges * mpi_bufferWords(level, buffer_send_info[b].sites[n].size()) * sizeof(double);
+			traffic[rank_node[neighbour_rank[n]] == rank_node[my_rank] ? 0 : 1] += bytes;
+		}
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &traffic[0], 2, MPI_DOUBLE, MPI_SUM, world_comm);
 
+	int numNodes = *std::max_element(rank_node.begin(), rank_node.end()) + 1;
+	double total = traffic[0] + traffic[1];
+	L_INFO("Halo exchange sends " + std::to_string(total / 1048576.0) + " MB per coarse time step of which " + 
+		std::to_string(total > 0.0 ? traffic[1] * 100.0 / total : 0.0) + "% travels between " + 
+		std::to_string(numNodes) + " nodes.", GridUtils::logfile);
 }
+
 // ************************************************************************* //
 /// \brief	Define writable sub-grid communicators.
 ///
@@ -1103,6 +1619,9 @@ int MpiManager::mpi_buildCommunicators(GridManager* const grid_man) {
 ///			refinement ratio. i.e. in 2D a coarse site refined to level 1 is 
 ///			represented	by 2^2 cells which each do 2^1 operations per coarse 
 ///			time step. Operation count is therefore 2^3 = 8 operations.
+///			The cost of these operations is also estimated from the site 
+///			labels and IB marker supports using the decomposition cost weights 
+///			and the resulting imbalance is logged by the master.
 ///
 ///	\param	grid_man	pointer to non-null grid manager.
 void MpiManager::mpi_updateLoadInfo(GridManager* const grid_man) {
@@ -1110,8 +1629,10 @@ void MpiManager::mpi_updateLoadInfo(GridManager* const grid_man) {
 	/* Loop over the grids and compute the number of ACTIVE cells on the rank.
 	 * In other words exclude the cells covered by a sub-grid. However, does 
 	 * include halo cells as these are part of the calculation. Count up ops
-	 * per coarse time step. */
+	 * per coarse time step. Also estimate the cost of these operations from 
+	 * the site labels using the decomposition cost weights. */
 	long ops_count = 0;
+	double cost = 0.0;
 
 	for (int lev = 0; lev < L_NUM_LEVELS + 1; ++lev)
 	{
@@ -1142,10 +1663,63 @@ void MpiManager::mpi_updateLoadInfo(GridManager* const grid_man) {
 					ops_count -= grid_cell_count * static_cast<long>(pow(2, lev - 1 - L_DIMS));
 				}
 
+				// Weight each site by its type
+				double grid_cost = 0.0;
+				for (long id = 0; id < grid_cell_count; ++id)
+				{
+					switch (g->LatTyp[id])
+					{
+					case eSolid:
+						grid_cost += L_MPI_COST_SOLID;
+						break;
+
+					case eRefined:
+						break;
+
+					case eTransitionToCoarser:
+					case eTransitionToFiner:
+						grid_cost += L_MPI_COST_TRANSITION;
+						break;
+
+					case eBFL:
+						grid_cost += L_MPI_COST_BFL;
+						break;
+
+					default:
+						grid_cost += 1.0;
+						break;
+					}
+				}
+				cost += grid_cost * pow(2, lev);
+
 			}
 		}
 	}
 
+#ifdef L_IBM_ON
+	// Add the cost of the support of the IB markers held on this rank
+	ObjectManager *objman = ObjectManager::getInstance();
+	for (size_t ib = 0; ib < objman->iBody.size(); ++ib)
+	{
+		IBBody &body = objman->iBody[ib];
+		for (size_t m = 0; m < body.validMarkers.size(); ++m)
+		{
+			cost += L_MPI_COST_IBM * body.markers[body.validMarkers[m]].supp_i.size() * pow(2, body.level);
+		}
+	}
+#endif
+
+	// Gather costs and report the imbalance they imply
+	std::vector<double> cost_buffer(num_ranks, 0.0);
+	MPI_Gather(&cost, 1, MPI_DOUBLE, &cost_buffer.front(), 1, MPI_DOUBLE, 0, world_comm);
+	if (my_rank == 0)
+	{
+		double max_cost = *std::max_element(cost_buffer.begin(), cost_buffer.end());
+		double min_cost = *std::min_element(cost_buffer.begin(), cost_buffer.end());
+		if (max_cost > 0.0)
+			L_INFO("Load imbalance estimated from site types is " + std::to_string((max_cost - min_cost) * 100.0 / max_cost) + "%.", GridUtils::logfile);
+	}
+
 	// Gather ops count (into root process)
 	long *ops_count_buffer = nullptr;
 	if (my_rank == 0)
@@ -1180,11 +1754,15 @@ void MpiManager::mpi_updateLoadInfo(GridManager* const grid_man) {
 		for (int process = 0; process < num_ranks; ++process)
 			if (ops_count_buffer[process] > max_load) max_load = static_cast<double>(ops_count_buffer[process]);
 
+		// Get max cost
+		double max_cost = *std::max_element(cost_buffer.begin(), cost_buffer.end());
+
 		for (int process = 0; process < num_ranks; ++process)
 		{
-			// Write process number, active count, load (as percentage of maximum)
+			// Write process number, active count, load (as percentage of maximum), cost, cost (as percentage of maximum)
 			counts_out << process << "\t" << ops_count_buffer[process] << "\t" << 
-				(static_cast<double>(ops_count_buffer[process]) * 100.0 / max_load) << std::endl;
+				(static_cast<double>(ops_count_buffer[process]) * 100.0 / max_load) << "\t" <<
+				cost_buffer[process] << "\t" << (cost_buffer[process] * 100.0 / max_cost) << std::endl;
 		}
 
 		counts_out.close();
@@ -1268,6 +1846,9 @@ void MpiManager::mpi_uniformDecompose(int *numCells)
 bool MpiManager::mpi_SDCheckDelta(SDData& solutionData, double dh, std::vector<int>& numCores)
 {
 
+	// Blocks must be at least as wide as the halo
+	double minWidth = L_MPI_HALO_DEPTH * dh;
+
 	// Declarations
 	bool bAdjustComplete = false;
 	bool bAdjusted = false;
@@ -1302,28 +1883,28 @@ bool MpiManager::mpi_SDCheckDelta(SDData& solutionData, double dh, std::vector<i
 						) continue;
 
 					// Perturbation cannot cause a block to have a zero size
-					if ((solutionData.XSol[i + 1] - solutionData.XSol[i]) < dh)
+					if ((solutionData.XSol[i + 1] - solutionData.XSol[i]) < minWidth)
 					{
-						// Adjust delta such that size is equal to dh
+						// Adjust delta such that size is equal to the minimum
 						c = i;
-						solutionData.delta[c] = solutionData.XSol[i] - solutionData.theta[c] + dh;
+						solutionData.delta[c] = solutionData.XSol[i] - solutionData.theta[c] + minWidth;
 						solutionData.thetaNew[c] = solutionData.theta[c] + solutionData.delta[c];
 						solutionData.XSol[i + 1] = solutionData.thetaNew[c];
 						bAdjusted = true;
 					}
-					if ((solutionData.YSol[j + 1] - solutionData.YSol[j]) < dh)
+					if ((solutionData.YSol[j + 1] - solutionData.YSol[j]) < minWidth)
 					{
 						c = numCores[eXDirection] - 1 + j;
-						solutionData.delta[c] = solutionData.YSol[j] - solutionData.theta[c] + dh;
+						solutionData.delta[c] = solutionData.YSol[j] - solutionData.theta[c] + minWidth;
 						solutionData.thetaNew[c] = solutionData.theta[c] + solutionData.delta[c];
 						solutionData.YSol[j + 1] = solutionData.thetaNew[c];
 						bAdjusted = true;
 					}
 #if (L_DIMS == 3)
-					if ((solutionData.ZSol[k + 1] - solutionData.ZSol[k]) < dh)
+					if ((solutionData.ZSol[k + 1] - solutionData.ZSol[k]) < minWidth)
 					{
 						c = numCores[eXDirection] + numCores[eYDirection] - 2 + k;
-						solutionData.delta[c] = solutionData.ZSol[k] - solutionData.theta[c] + dh;
+						solutionData.delta[c] = solutionData.ZSol[k] - solutionData.theta[c] + minWidth;
 						solutionData.thetaNew[c] = solutionData.theta[c] + solutionData.delta[c];
 						solutionData.ZSol[k + 1] = solutionData.thetaNew[c];
 						bAdjusted = true;
@@ -1380,9 +1961,9 @@ void MpiManager::mpi_SDReconstructSolution(SDData& solutionData, std::vector<int
 void MpiManager::mpi_SDComputeImbalance(LoadImbalanceData& load,
 	SDData& solutionData, std::vector<int>& numCores)
 {
-	size_t count = 0;
-	size_t countMax = 0;
-	size_t countMin = std::numeric_limits<size_t>::max();
+	double count = 0.0;
+	double countMax = 0.0;
+	double countMin = std::numeric_limits<double>::max();
 
 	// Construct bounds for each block and then find active cell count from grid manager
 	double bounds[6];
@@ -1400,8 +1981,11 @@ void MpiManager::mpi_SDComputeImbalance(LoadImbalanceData& load,
 				bounds[eZMin] = solutionData.ZSol[k];
 				bounds[eZMax] = solutionData.ZSol[k + 1];
 
-				// Get active operation count
-				count = GridManager::getInstance()->getActiveCellCount(&bounds[0], true);
+				// Get cost of the block (from the prefix-sum table if available)
+				if (sd_cost_table.empty())
+					count = mpi_SDBlockCost(&bounds[0]);
+				else
+					count = mpi_SDTableCost(&bounds[0]);
 
 				// Update the extremes
 				if (count > countMax)
@@ -1418,10 +2002,311 @@ void MpiManager::mpi_SDComputeImbalance(LoadImbalanceData& load,
 	}
 
 	// Update load imbalance
-	load.loadImbalance = 
-		std::abs(static_cast<double>(countMax) - static_cast<double>(countMin)) * 100.0 / static_cast<double>(countMax);
-	load.heaviestOps = countMax;
+	load.loadImbalance = std::abs(countMax - countMin) * 100.0 / countMax;
+	load.heaviestOps = static_cast<size_t>(countMax);
+
+}
+
+// ************************************************************************* //
+/// \brief	Cost of a candidate block for the smart decomposition.
+///
+///			By default this is the active operation count within the block 
+///			weighted by site type. If the dynamic load balancer has supplied 
+///			measured weights then the cost the block shares with each measured 
+///			rank core is scaled by the time per unit cost measured on that rank.
+///
+///	\param	bounds	pointer to an array containing the bounds of the block.
+///	\returns		cost of the block.
+double MpiManager::mpi_SDBlockCost(double *bounds)
+{
+	GridManager *gm = GridManager::getInstance();
+
+	// Cost from site-type weights
+	if (balance_rank_weights.empty())
+		return gm->getActiveCellCost(bounds);
+
+	// Sum the weighted contributions of each measured block
+	double cost = 0.0;
+	double overlap[6];
+	for (int rank = 0; rank < num_ranks; ++rank)
+	{
+		if (balance_rank_weights[rank] == 0.0) continue;
+
+		// Intersection of candidate block and measured block
+		bool bEmpty = false;
+		for (int e = eXMin; e < 2 * L_DIMS; e += 2)
+		{
+			overlap[e] = std::max(bounds[e], balance_weight_edges[e][rank]);
+			overlap[e + 1] = std::min(bounds[e + 1], balance_weight_edges[e + 1][rank]);
+			if (overlap[e + 1] <= overlap[e]) bEmpty = true;
+		}
+#if (L_DIMS != 3)
+		overlap[eZMin] = bounds[eZMin];
+		overlap[eZMax] = bounds[eZMax];
+#endif
+		if (bEmpty) continue;
+
+		cost += balance_rank_weights[rank] * gm->getActiveCellCost(&overlap[0]);
+	}
+
+	return cost;
+}
+
+// ************************************************************************* //
+/// \brief	Build the prefix-sum table of coarse cell costs.
+///
+///			The cost of each coarse cell is evaluated once using the smart 
+///			decomposition cost function, with the X planes shared between the 
+///			ranks, and accumulated into a summed-volume table so that the cost 
+///			of any block aligned with the coarse grid can be found in constant 
+///			time. Called by all ranks.
+///
+///	\param	dh	coarse cell spacing.
+void MpiManager::mpi_SDBuildCostTable(double dh)
+{
+	GridManager *gm = GridManager::getInstance();
+
+	// Number of coarse cells in each direction (Z is not decomposed in 2D)
+	int nx = L_N;
+	int ny = L_M;
+#if (L_DIMS == 3)
+	int nz = L_K;
+#else
+	int nz = 1;
+#endif
+	sd_table_size[eXDirection] = nx + 1;
+	sd_table_size[eYDirection] = ny + 1;
+	sd_table_size[eZDirection] = nz + 1;
+
+	// Share the X planes between the ranks
+	std::vector<int> counts(num_ranks, 0);
+	std::vector<int> disps(num_ranks, 0);
+	for (int rank = 0; rank < num_ranks; ++rank)
+	{
+		int iStart = static_cast<int>((static_cast<long>(rank) * nx) / num_ranks);
+		int iEnd = static_cast<int>((static_cast<long>(rank + 1) * nx) / num_ranks);
+		counts[rank] = (iEnd - iStart) * ny * nz;
+		disps[rank] = iStart * ny * nz;
+	}
+
+	// Cost of the cells in the planes of this rank
+	std::vector<double> myCosts(counts[my_rank], 0.0);
+	double bounds[6];
+	bounds[eZMin] = 0.0;
+	bounds[eZMax] = gm->global_edges[eZMax][0];
+	int c = 0;
+	for (int i = disps[my_rank] / (ny * nz); i < (disps[my_rank] + counts[my_rank]) / (ny * nz); ++i)
+	{
+		for (int j = 0; j < ny; ++j)
+		{
+			for (int k = 0; k < nz; ++k)
+			{
+				bounds[eXMin] = i * dh;
+				bounds[eXMax] = (i + 1) * dh;
+				bounds[eYMin] = j * dh;
+				bounds[eYMax] = (j + 1) * dh;
+#if (L_DIMS == 3)
+				bounds[eZMin] = k * dh;
+				bounds[eZMax] = (k + 1) * dh;
+#endif
+				myCosts[c++] = mpi_SDBlockCost(&bounds[0]);
+			}
+		}
+	}
+
+	// Share the cell costs
+	std::vector<double> cellCosts(nx * ny * nz, 0.0);
+	MPI_Allgatherv(myCosts.data(), counts[my_rank], MPI_DOUBLE,
+		cellCosts.data(), counts.data(), disps.data(), MPI_DOUBLE, world_comm);
+
+	// Accumulate into the summed-volume table
+	sd_cost_table.assign(static_cast<size_t>(nx + 1) * (ny + 1) * (nz + 1), 0.0);
+	for (int i = 0; i < nx; ++i)
+	{
+		for (int j = 0; j < ny; ++j)
+		{
+			for (int k = 0; k < nz; ++k)
+			{
+				sd_cost_table[mpi_SDTableIndex(i + 1, j + 1, k + 1)] = cellCosts[k + j * nz + i * ny * nz]
+					+ sd_cost_table[mpi_SDTableIndex(i, j + 1, k + 1)]
+					+ sd_cost_table[mpi_SDTableIndex(i + 1, j, k + 1)]
+					+ sd_cost_table[mpi_SDTableIndex(i + 1, j + 1, k)]
+					- sd_cost_table[mpi_SDTableIndex(i, j, k + 1)]
+					- sd_cost_table[mpi_SDTableIndex(i, j + 1, k)]
+					- sd_cost_table[mpi_SDTableIndex(i + 1, j, k)]
+					+ sd_cost_table[mpi_SDTableIndex(i, j, k)];
+			}
+		}
+	}
+}
+
+// ************************************************************************* //
+/// \brief	Cost of a block from the prefix-sum table.
+///
+///			Block edges are snapped to the nearest coarse cell edge.
+///
+///	\param	bounds	pointer to an array containing the bounds of the block.
+///	\returns		cost of the block.
+double MpiManager::mpi_SDTableCost(double *bounds)
+{
+	double dh = L_COARSE_SITE_WIDTH;
+	int lo[3], hi[3];
+	for (int d = 0; d < 3; ++d)
+	{
+		lo[d] = static_cast<int>(std::round(bounds[2 * d] / dh));
+		hi[d] = static_cast<int>(std::round(bounds[2 * d + 1] / dh));
+		lo[d] = std::min(std::max(lo[d], 0), sd_table_size[d] - 1);
+		hi[d] = std::min(std::max(hi[d], 0), sd_table_size[d] - 1);
+	}
+#if (L_DIMS != 3)
+	lo[eZDirection] = 0;
+	hi[eZDirection] = 1;
+#endif
+
+	return mpi_SDTableCost(&lo[0], &hi[0]);
+}
+
+// ************************************************************************* //
+/// \brief	Cost of a block of coarse cells from the prefix-sum table.
+///
+///	\param	lo		pointer to the indices of the first cell edges of the block.
+///	\param	hi		pointer to the indices of the last cell edges of the block.
+///	\returns		cost of the block.
+double MpiManager::mpi_SDTableCost(int *lo, int *hi)
+{
+	return sd_cost_table[mpi_SDTableIndex(hi[0], hi[1], hi[2])]
+		- sd_cost_table[mpi_SDTableIndex(lo[0], hi[1], hi[2])]
+		- sd_cost_table[mpi_SDTableIndex(hi[0], lo[1], hi[2])]
+		- sd_cost_table[mpi_SDTableIndex(hi[0], hi[1], lo[2])]
+		+ sd_cost_table[mpi_SDTableIndex(lo[0], lo[1], hi[2])]
+		+ sd_cost_table[mpi_SDTableIndex(lo[0], hi[1], lo[2])]
+		+ sd_cost_table[mpi_SDTableIndex(hi[0], lo[1], lo[2])]
+		- sd_cost_table[mpi_SDTableIndex(lo[0], lo[1], lo[2])];
+}
+
+// ************************************************************************* //
+/// \brief	Optimise the block edges one direction at a time.
+///
+///			With the planes in the other directions held fixed, the planes in 
+///			one direction are placed to minimise the cost of the heaviest block 
+///			exactly, by bisection on the heaviest cost with a greedy feasibility 
+///			test. Directions are swept in turn until no further improvement is 
+///			found. Requires the prefix-sum table.
+///
+///	\param	solutionData	structure to hold SD information.
+///	\param	numCores		reference to vector holding core topology.
+///	\param	dh				coarse cell spacing.
+void MpiManager::mpi_SDExactPartition(SDData& solutionData, std::vector<int>& numCores, double dh)
+{
+	// Plane indices in each direction
+	std::vector<double> *sol[3] = { &solutionData.XSol, &solutionData.YSol, &solutionData.ZSol };
+	std::vector<int> planes[3];
+	for (int d = 0; d < 3; ++d)
+	{
+		planes[d].resize(numCores[d] + 1);
+		for (int p = 0; p <= numCores[d]; ++p)
+			planes[d][p] = static_cast<int>(std::round((*sol[d])[p] / dh));
+	}
+#if (L_DIMS != 3)
+	planes[eZDirection][0] = 0;
+	planes[eZDirection][1] = 1;
+#endif
+
+	// Heaviest block in a slab of direction d between plane indices a and b
+	auto slabCost = [&](int d, int a, int b) -> double
+	{
+		int d1 = (d + 1) % 3, d2 = (d + 2) % 3;
+		int lo[3], hi[3];
+		lo[d] = a;
+		hi[d] = b;
+		double maxCost = 0.0;
+		for (size_t p1 = 0; p1 + 1 < planes[d1].size(); ++p1)
+		{
+			lo[d1] = planes[d1][p1];
+			hi[d1] = planes[d1][p1 + 1];
+			for (size_t p2 = 0; p2 + 1 < planes[d2].size(); ++p2)
+			{
+				lo[d2] = planes[d2][p2];
+				hi[d2] = planes[d2][p2 + 1];
+				maxCost = std::max(maxCost, mpi_SDTableCost(&lo[0], &hi[0]));
+			}
+		}
+		return maxCost;
+	};
+
+	// Heaviest block of the whole decomposition
+	auto heaviest = [&]() -> double
+	{
+		double maxCost = 0.0;
+		for (size_t p = 0; p + 1 < planes[eXDirection].size(); ++p)
+			maxCost = std::max(maxCost, slabCost(eXDirection, planes[eXDirection][p], planes[eXDirection][p + 1]));
+		return maxCost;
+	};
+
+	// Greedily place the planes of direction d such that no block exceeds the limit
+	auto partition = [&](int d, double limit, std::vector<int>& result) -> bool
+	{
+		int n = planes[d].back();
+		int parts = numCores[d];
+		result.assign(parts + 1, 0);
+		result[parts] = n;
+		int start = 0;
+		for (int p = 0; p < parts - 1; ++p)
+		{
+			// Every block needs to be at least as wide as the halo
+			int end = start + L_MPI_HALO_DEPTH;
+			if (end > n - (parts - 1 - p) * L_MPI_HALO_DEPTH || slabCost(d, start, end) > limit) return false;
+			while (end + 1 <= n - (parts - 1 - p) * L_MPI_HALO_DEPTH && slabCost(d, start, end + 1) <= limit) end++;
+			result[p + 1] = end;
+			start = end;
+		}
+		return slabCost(d, start, n) <= limit;
+	};
+
+	// Sweep the directions until no improvement
+	double best = heaviest();
+	bool bImproved = true;
+	for (int sweep = 0; sweep < L_MPI_SD_MAX_ITER && bImproved; ++sweep)
+	{
+		bImproved = false;
+		for (int d = 0; d < L_DIMS; ++d)
+		{
+			if (numCores[d] == 1) continue;
+
+			// Bisect on the heaviest block cost
+			double lo = 0.0;
+			double hi = best;
+			std::vector<int> trial, feasible(planes[d]);
+			for (int it = 0; it < 60; ++it)
+			{
+				double mid = 0.5 * (lo + hi);
+				if (partition(d, mid, trial))
+				{
+					hi = mid;
+					feasible = trial;
+				}
+				else lo = mid;
+			}
+
+			// Adopt if better
+			std::vector<int> current(planes[d]);
+			planes[d] = feasible;
+			double cost = heaviest();
+			if (cost < best * (1.0 - L_SMALL_NUMBER))
+			{
+				best = cost;
+				bImproved = true;
+			}
+			else planes[d] = current;
+		}
+	}
 
+	// Convert back to positions (outer edges unchanged)
+	for (int d = 0; d < L_DIMS; ++d)
+	{
+		for (int p = 1; p < numCores[d]; ++p)
+			(*sol[d])[p] = planes[d][p] * dh;
+	}
 }
 
 // ************************************************************************* //
@@ -1440,9 +2325,9 @@ MpiManager::LoadImbalanceData MpiManager::mpi_smartDecompose(double dh, std::vec
 	std::vector<int> numCores(3);
 	if (!reqDims.size())
 	{
-		numCores[eXDirection] = L_MPI_XCORES;
-		numCores[eYDirection] = L_MPI_YCORES;
-		numCores[eZDirection] = L_MPI_ZCORES;
+		numCores[eXDirection] = dimensions[eXDirection];
+		numCores[eYDirection] = dimensions[eYDirection];
+		numCores[eZDirection] = dimensions[eZDirection];
 	}
 	else
 	{
@@ -1458,8 +2343,9 @@ MpiManager::LoadImbalanceData MpiManager::mpi_smartDecompose(double dh, std::vec
 	// Create imbalance structure
 	LoadImbalanceData load;
 
-	// Only rank 0 does the calculation and result is pushed to other ranks
-	if (my_rank == 0)
+	/* Only rank 0 does the calculation and result is pushed to other ranks.
+	 * Requested topologies are evaluated by the calling rank only. */
+	if (my_rank == 0 || reqDims.size())
 	{
 		// Data
 		int p = (numCores[eXDirection] + numCores[eYDirection] + numCores[eZDirection]) - 3;	// Number of unknowns
@@ -1514,9 +2400,30 @@ MpiManager::LoadImbalanceData MpiManager::mpi_smartDecompose(double dh, std::vec
 		// Update uniform decomposition quantity
 		load.uniImbalance = load.loadImbalance;
 #ifndef L_MPI_TOPOLOGY_REPORT
-		L_INFO("Uniform decomposition produces an imbalance of " + std::to_string(load.uniImbalance) + "%.", GridUtils::logfile);
+		if (!reqDims.size())
+			L_INFO("Uniform decomposition produces an imbalance of " + std::to_string(load.uniImbalance) + "%.", GridUtils::logfile);
 #endif
 
+#ifdef L_MPI_SD_EXACT
+
+		// Optimise plane positions one direction at a time
+		SDData tempData(solutionData);		// Make a copy
+		LoadImbalanceData tmpLoad(load);	// Make a copy
+		mpi_SDExactPartition(tempData, numCores, dh);
+		mpi_SDComputeImbalance(tmpLoad, tempData, numCores);
+
+		// Keep if the heaviest block is lighter than with uniform decomposition
+		if (tmpLoad.heaviestOps < load.heaviestOps)
+		{
+			load.loadImbalance = tmpLoad.loadImbalance;
+			load.heaviestOps = tmpLoad.heaviestOps;
+			solutionData.XSol = tempData.XSol;
+			solutionData.YSol = tempData.YSol;
+			solutionData.ZSol = tempData.ZSol;
+		}
+
+#else
+
 		// Temporaries
 		SDData tempData(solutionData);		// Make a copy
 		LoadImbalanceData tmpLoad(load);	// Make a copy
@@ -1602,6 +2509,8 @@ MpiManager::LoadImbalanceData MpiManager::mpi_smartDecompose(double dh, std::vec
 			// Increment k
 			k++;
 		}
+
+#endif
 	}
 
 	// Communicate information around topology if not performing a report
@@ -1651,7 +2560,7 @@ void MpiManager::mpi_SDCommunicateSolution(SDData& solutionData, double imbalanc
 	}
 
 	// Update ranks sizes from solution
-	MPI_Bcast(bufRankSizeStart, L_MPI_XCORES * L_MPI_YCORES * L_MPI_ZCORES * L_DIMS, MPI_INT, 0, world_comm);
+	MPI_Bcast(bufRankSizeStart, num_ranks * L_DIMS, MPI_INT, 0, world_comm);
 	int blockIdx = 0;
 	bufRankSize = bufRankSizeStart;
 	for (int i = 0; i < dimensions[eXDirection]; i++)
@@ -1674,6 +2583,228 @@ void MpiManager::mpi_SDCommunicateSolution(SDData& solutionData, double imbalanc
 	delete[] bufRankSizeStart;
 
 }
+// ************************************************************************** //
+/// \brief	Chooses the unconstrained directions of the topology using the 
+///			smart decomposition cost model.
+///
+///			Each topology with the available number of ranks which respects the 
+///			requested dimensions is decomposed, with the candidates shared 
+///			between the ranks, and the one with the lowest imbalance is adopted. 
+///			If it differs from the topology built at initialisation the 
+///			Cartesian communicator is rebuilt with the rank numbering preserved 
+///			(unless placing ranks by node).
+///
+///	\param	dh			coarse cell spacing.
+void MpiManager::mpi_SDSelectDims(double dh)
+{
+	// Requested dimensions (zero entries are free)
+	int reqDims[3] = { L_MPI_XCORES, L_MPI_YCORES, L_MPI_ZCORES };
+	if ((reqDims[0] != 0 && reqDims[1] != 0 && reqDims[2] != 0) || num_ranks == 1) return;
+
+	// Enumerate the candidate topologies (identically on every rank)
+	std::vector< std::vector<int> > candidates;
+	for (int i = 1; i <= num_ranks; ++i)
+	{
+		if (num_ranks % i != 0 || (reqDims[0] != 0 && i != reqDims[0])) continue;
+		for (int j = 1; j <= num_ranks / i; ++j)
+		{
+			if ((num_ranks / i) % j != 0 || (reqDims[1] != 0 && j != reqDims[1])) continue;
+			int k = num_ranks / (i * j);
+			if (reqDims[2] != 0 && k != reqDims[2]) continue;
+
+			// Cannot have more ranks than sites in a direction
+			if (i > L_N || j > L_M || (L_DIMS == 3 && k > L_K)) continue;
+
+			candidates.push_back({ i, j, k });
+		}
+	}
+
+	// Candidates are shared round-robin between the ranks
+	struct { double imbalance; int idx; } myBest, best;
+	myBest.imbalance = std::numeric_limits<double>::max();
+	myBest.idx = static_cast<int>(candidates.size());
+	for (size_t c = my_rank; c < candidates.size(); c += num_ranks)
+	{
+		double imbalance = mpi_smartDecompose(dh, candidates[c]).loadImbalance;
+
+		// Adopt if strictly better (ties keep the first found)
+		if (imbalance < myBest.imbalance)
+		{
+			myBest.imbalance = imbalance;
+			myBest.idx = static_cast<int>(c);
+		}
+	}
+
+	// Share the choice (ties resolved to the first candidate)
+	MPI_Allreduce(&myBest, &best, 1, MPI_DOUBLE_INT, MPI_MINLOC, world_comm);
+	if (best.idx >= static_cast<int>(candidates.size())) return;
+	int bestDims[3] = { candidates[best.idx][0], candidates[best.idx][1], candidates[best.idx][2] };
+	if (bestDims[0] == dimensions[0] && bestDims[1] == dimensions[1] && bestDims[2] == dimensions[2]) return;
+
+	// Rebuild the topology keeping the rank numbering
+	dimensions[0] = bestDims[0];
+	dimensions[1] = bestDims[1];
+	dimensions[2] = bestDims[2];
+	MPI_Comm old_comm = world_comm;
+	mpi_setTopology(old_comm, false);
+	MPI_Comm_free(&old_comm);
+
+	L_INFO("MPI topology changed to " + std::to_string(dimensions[eXDirection]) + "x" +
+		std::to_string(dimensions[eYDirection]) + "x" + std::to_string(dimensions[eZDirection]) + 
+		" by smart decomposition.", GridUtils::logfile);
+}
+
+// ************************************************************************** //
+/// \brief	Decomposes the domain by recursive bisection of the weighted cost.
+///
+///			The box of coarse cells is split in two by the plane which best 
+///			balances the cost per rank of the two halves, trying every plane in 
+///			every direction, and the halves are split again until each holds 
+///			one rank. Ranks are numbered in the order in which the boxes are 
+///			created so the blocks of neighbouring ranks are close in space. 
+///			The resulting blocks need not form a Cartesian topology. Rank 0 
+///			does the work using the prefix-sum table and the block edges are 
+///			broadcast. Called by all ranks.
+///
+///	\param	dh			coarse cell spacing.
+///	\returns			percentage difference between the lightest and heaviest blocks.
+double MpiManager::mpi_rcbDecompose(double dh)
+{
+	rank_core_edge.resize(6, std::vector<double>(num_ranks));
+	double imbalance = 0.0;
+#if (L_DIMS != 3)
+	GridManager *gm = GridManager::getInstance();
+#endif
+
+	if (my_rank == 0)
+	{
+		// Whether a box can hold a number of blocks at least two cells (and one halo) wide
+		const int minWidth = std::max(2, L_MPI_HALO_DEPTH);
+		auto canHold = [minWidth](int *lo, int *hi, int n)
+		{
+			long blocks = 1;
+			for (int d = 0; d < L_DIMS; ++d) blocks *= (hi[d] - lo[d]) / minWidth;
+			return blocks >= n;
+		};
+
+		// Split a box between a contiguous set of ranks
+		std::function<void(int*, int*, int, int)> split = [&](int *lo, int *hi, int firstRank, int n)
+		{
+			if (n == 1)
+			{
+				for (int d = 0; d < 3; ++d)
+				{
+					rank_core_edge[2 * d][firstRank] = lo[d] * dh;
+					rank_core_edge[2 * d + 1][firstRank] = hi[d] * dh;
+				}
+#if (L_DIMS != 3)
+				rank_core_edge[eZMin][firstRank] = 0.0;
+				rank_core_edge[eZMax][firstRank] = gm->global_edges[eZMax][0];
+#endif
+				return;
+			}
+
+			// Try every plane keeping the one which balances best (ties go to the smaller cut)
+			int nL = n / 2, nR = n - nL;
+			int bestDir = -1, bestCut = 0;
+			double bestCost = std::numeric_limits<double>::max();
+			long bestArea = std::numeric_limits<long>::max();
+			for (int d = 0; d < L_DIMS; ++d)
+			{
+				long area = 1;
+				for (int e = 0; e < L_DIMS; ++e) if (e != d) area *= (hi[e] - lo[e]);
+
+				for (int c = lo[d] + minWidth; c <= hi[d] - minWidth; ++c)
+				{
+					int midHi[3] = { hi[0], hi[1], hi[2] };
+					int midLo[3] = { lo[0], lo[1], lo[2] };
+					midHi[d] = c;
+					midLo[d] = c;
+					if (!canHold(lo, midHi, nL) || !canHold(midLo, hi, nR)) continue;
+
+					double cost = std::max(mpi_SDTableCost(lo, midHi) / nL, mpi_SDTableCost(midLo, hi) / nR);
+					if (cost < bestCost || (cost == bestCost && area < bestArea))
+					{
+						bestCost = cost;
+						bestArea = area;
+						bestDir = d;
+						bestCut = c;
+					}
+				}
+			}
+
+			if (bestDir == -1)
+			{
+				L_ERROR("Recursive bisection could not split a block between " + std::to_string(n) + 
+					" ranks. Use fewer ranks or a finer coarse grid.", GridUtils::logfile);
+			}
+
+			// Recurse into the two halves
+			int leftHi[3] = { hi[0], hi[1], hi[2] };
+			int rightLo[3] = { lo[0], lo[1], lo[2] };
+			leftHi[bestDir] = bestCut;
+			rightLo[bestDir] = bestCut;
+			split(lo, leftHi, firstRank, nL);
+			split(rightLo, hi, firstRank + nL, nR);
+		};
+
+		int lo[3] = { 0, 0, 0 };
+		int hi[3] = { sd_table_size[eXDirection] - 1, sd_table_size[eYDirection] - 1, sd_table_size[eZDirection] - 1 };
+		split(&lo[0], &hi[0], 0, num_ranks);
+
+		imbalance = mpi_predictImbalance();
+		L_INFO("Recursive bisection finished. Imbalance of " + std::to_string(imbalance) + "%.", GridUtils::logfile);
+	}
+
+	// Share the block edges and imbalance
+	mpi_communicateBlockEdges();
+	MPI_Bcast(&imbalance, 1, MPI_DOUBLE, 0, world_comm);
+
+	// Keep the rank sizes consistent with the edges
+	cRankSizeX.resize(num_ranks);
+	cRankSizeY.resize(num_ranks);
+	cRankSizeZ.resize(num_ranks);
+	for (int rank = 0; rank < num_ranks; ++rank)
+	{
+		cRankSizeX[rank] = static_cast<int>(std::round((rank_core_edge[eXMax][rank] - rank_core_edge[eXMin][rank]) / dh));
+		cRankSizeY[rank] = static_cast<int>(std::round((rank_core_edge[eYMax][rank] - rank_core_edge[eYMin][rank]) / dh));
+		cRankSizeZ[rank] = static_cast<int>(std::round((rank_core_edge[eZMax][rank] - rank_core_edge[eZMin][rank]) / dh));
+	}
+
+	return imbalance;
+}
+
+// ************************************************************************** //
+/// \brief	Computes the imbalance expected from the current block edges.
+///
+///			The cost of each block is evaluated with the smart decomposition 
+///			cost function, or the prefix-sum table if it exists.
+///
+///	\returns	percentage difference between the lightest and heaviest blocks.
+double MpiManager::mpi_predictImbalance()
+{
+	double countMax = 0.0;
+	double countMin = std::numeric_limits<double>::max();
+	double bounds[6];
+
+	for (int rank = 0; rank < num_ranks; ++rank)
+	{
+		for (int e = 0; e < 6; ++e) bounds[e] = rank_core_edge[e][rank];
+
+		// Z is not decomposed in 2D
+#if (L_DIMS != 3)
+		bounds[eZMin] = 0.0;
+		bounds[eZMax] = GridManager::getInstance()->global_edges[eZMax][0];
+#endif
+		double count = sd_cost_table.empty() ? mpi_SDBlockCost(&bounds[0]) : mpi_SDTableCost(&bounds[0]);
+		if (count > countMax) countMax = count;
+		if (count < countMin) countMin = count;
+	}
+
+	if (countMax == 0.0) return 0.0;
+	return (countMax - countMin) * 100.0 / countMax;
+}
+
 // ************************************************************************** //
 /// \brief	Writes a report on imbalances from different decomposition topologies.
 ///
@@ -1692,18 +2823,36 @@ void MpiManager::mpi_reportOnDecomposition(double dh)
 
 	L_WARN("Topology report mode enabled. No simulation will take place.", GridUtils::logfile);
 
+	// Cases are shared round-robin between the ranks
+	int numCases = L_MPI_TOP_XCORES * L_MPI_TOP_YCORES * L_MPI_TOP_ZCORES;
+	std::vector<double> results(3 * numCases, 0.0);
+	std::vector<int> coreCombo(3);
+	for (int c = my_rank; c < numCases; c += num_ranks)
+	{
+		coreCombo[eXDirection] = c / (L_MPI_TOP_ZCORES * L_MPI_TOP_YCORES) + 1;
+		coreCombo[eYDirection] = (c / L_MPI_TOP_ZCORES) % L_MPI_TOP_YCORES + 1;
+		coreCombo[eZDirection] = c % L_MPI_TOP_ZCORES + 1;
+		LoadImbalanceData load;
+		load = mpi_smartDecompose(dh, coreCombo);
+		results[3 * c] = load.loadImbalance;
+		results[3 * c + 1] = load.uniImbalance;
+		results[3 * c + 2] = load.heaviestOps;
+	}
+
+	// Collect the results on rank 0
+	std::vector<double> allResults(3 * numCases, 0.0);
+	MPI_Reduce(results.data(), allResults.data(), 3 * numCases, MPI_DOUBLE, MPI_SUM, 0, world_comm);
+
 	if (my_rank == 0)
 	{
 		// Declarations
-		std::vector<int> coreCombo(3);
-		std::string logInfo;
 		std::ofstream reportFile;
 		reportFile.open(GridUtils::path_str + "/topologyreport.out", std::ios::out);
 		if (!reportFile.is_open()) L_ERROR("Could not open topology report file. Exiting.", GridUtils::logfile);
 		L_INFO("Writing report...", GridUtils::logfile);
 
 		// Write header
-		reportFile << "Case\tXCORES\tYCORES\tZCORES\tTotalCore\tImbalance\tUniform\tHeaviestOps\t" << std::endl;
+		reportFile << "Case\tXCORES\tYCORES\tZCORES\tTotalCore\tImbalance\tUniform\tHeaviestCost\t" << std::endl;
 
 		// Loop over each case
 		for (int i = 1; i < L_MPI_TOP_XCORES + 1; ++i)
@@ -1712,23 +2861,17 @@ void MpiManager::mpi_reportOnDecomposition(double dh)
 			{
 				for (int k = 1; k < L_MPI_TOP_ZCORES + 1; ++k)
 				{
-					coreCombo[eXDirection] = i;
-					coreCombo[eYDirection] = j;
-					coreCombo[eZDirection] = k;
-					LoadImbalanceData load;
-					load = mpi_smartDecompose(dh, coreCombo);
+					int c = (k - 1) + (j - 1) * L_MPI_TOP_ZCORES + (i - 1) * L_MPI_TOP_ZCORES * L_MPI_TOP_YCORES;
 
 					// Log information
-					reportFile << std::to_string(
-						(k - 1) + (j - 1) * L_MPI_TOP_ZCORES + (i - 1) * L_MPI_TOP_ZCORES * L_MPI_TOP_YCORES
-						) + "\t";
+					reportFile << std::to_string(c) + "\t";
 					reportFile << std::to_string(i) + "\t";
 					reportFile << std::to_string(j) + "\t";
 					reportFile << std::to_string(k) + "\t";
 					reportFile << std::to_string(i * j * k) + "\t";
-					reportFile << std::to_string(load.loadImbalance) + "\t";
-					reportFile << std::to_string(load.uniImbalance) + "\t";
-					reportFile << std::to_string(load.heaviestOps);
+					reportFile << std::to_string(allResults[3 * c]) + "\t";
+					reportFile << std::to_string(allResults[3 * c + 1]) + "\t";
+					reportFile << std::to_string(allResults[3 * c + 2]);
 					reportFile << std::endl;
 				}
 			}
@@ -1843,3 +2986,78 @@ std::vector<int> MpiManager::mpi_mapRankWorldToLevel(int level) {
 	// Return
 	return mapping;
 }
+
+// *****************************************************************************
+///	\brief	Exchange messages with an irregular set of ranks
+///
+///			Uses the non-blocking consensus (NBX) protocol so that no rank 
+///			needs to know in advance which ranks will send to it. Messages are
+///			sent synchronously and received as they are probed until a 
+///			non-blocking barrier, entered once all local sends have been 
+///			matched, completes on every rank. The cost therefore scales with
+///			the number of ranks actually exchanged with rather than the size 
+///			of the communicator. Consecutive exchanges on the same 
+///			communicator must use different tags unless another collective 
+///			separates them.
+///
+///	\param	comm			communicator of the ranks taking part
+///	\param	tag				tag of the messages
+///	\param	toRanks			ranks (in comm) to send to
+///	\param	sendBuffers		message for each rank in toRanks
+///	\param	fromRanks		ranks (in comm) received from in ascending order
+///	\param	recvBuffers		message received from each rank in fromRanks
+void MpiManager::mpi_sparseExchange(MPI_Comm comm, int tag,
+	const std::vector<int> &toRanks, const std::vector<std::vector<double>> &sendBuffers,
+	std::vector<int> &fromRanks, std::vector<std::vector<double>> &recvBuffers) {
+
+	// Post the synchronous sends
+	std::vector<MPI_Request> sendRequests(toRanks.size());
+	for (size_t n = 0; n < toRanks.size(); n++) {
+		MPI_Issend(sendBuffers[n].data(), static_cast<int>(sendBuffers[n].size()),
+			MPI_DOUBLE, toRanks[n], tag, comm, &sendRequests[n]);
+	}
+
+	// Receive until every rank has had all of its messages matched
+	std::vector<int> source;
+	std::vector<std::vector<double>> recv;
+	MPI_Request barrier = MPI_REQUEST_NULL;
+	bool barrierPosted = false;
+	int done = 0;
+	while (!done) {
+
+		// Receive any message which has arrived
+		int flag, count;
+		MPI_Status status;
+		MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &flag, &status);
+		if (flag) {
+			MPI_Get_count(&status, MPI_DOUBLE, &count);
+			source.push_back(status.MPI_SOURCE);
+			recv.emplace_back(count);
+			MPI_Recv(recv.back().data(), count, MPI_DOUBLE, status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE);
+		}
+
+		// Enter the barrier once the local sends are matched, then wait for the others
+		if (barrierPosted) {
+			MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+		}
+		else {
+			int sent;
+			MPI_Testall(static_cast<int>(sendRequests.size()), sendRequests.data(), &sent, MPI_STATUSES_IGNORE);
+			if (sent) {
+				MPI_Ibarrier(comm, &barrier);
+				barrierPosted = true;
+			}
+		}
+	}
+
+	// Order the messages by source so unpacking does not depend on arrival order
+	std::vector<size_t> order(source.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return source[a] < source[b]; });
+	fromRanks.resize(order.size());
+	recvBuffers.resize(order.size());
+	for (size_t n = 0; n < order.size(); n++) {
+		fromRanks[n] = source[order[n]];
+		recvBuffers[n].swap(recv[order[n]]);
+	}
+}
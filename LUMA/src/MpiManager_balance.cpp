@@ -0,0 +1,572 @@
+/*
+* --------------------------------------------------------------
+*
+* ------ Lattice Boltzmann @ The University of Manchester ------
+*
+* -------------------------- L-U-M-A ---------------------------
+*
+* Copyright 2018 The University of Manchester
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.*
+*/
+
+#include "../inc/stdafx.h"
+#include "../inc/GridObj.h"
+#include "../inc/ObjectManager.h"
+
+
+// ************************************************************************* //
+/// \brief	Dynamic load balancing.
+///
+///			Called by all ranks. Gathers the compute time measured on each rank
+///			since the last call and, if the imbalance exceeds the threshold,
+///			re-runs the smart decomposition with the block cost weighted by the
+///			measured cost per operation of each rank. If the new decomposition
+///			is predicted to be better, the grid hierarchy is rebuilt on the new
+///			blocks, the lattice data and IB markers are migrated and all the
+///			buffers and communicators are rebuilt. Only data moves between 
+///			ranks whose old and new blocks overlap.
+///
+///			BFL bodies are not supported by the migration so the check is
+///			skipped if any are present. If IB bodies exist on sub-grids, a new
+///			decomposition which changes the sub-grids present on any rank is
+///			rejected as these bodies only exist on ranks owning their grid.
+///
+///	\param	grid_man	pointer to non-null grid manager.
+///	\returns			true if the domain was re-decomposed.
+bool MpiManager::mpi_dynamicBalance(GridManager* const grid_man)
+{
+	// Gather measured compute time from all ranks and reset the measurement
+	std::vector<double> rankTimes(num_ranks, 0.0);
+	MPI_Allgather(&balance_compute_time, 1, MPI_DOUBLE, &rankTimes.front(), 1, MPI_DOUBLE, world_comm);
+	balance_compute_time = 0.0;
+
+	// Measured imbalance
+	double maxTime = *std::max_element(rankTimes.begin(), rankTimes.end());
+	double minTime = *std::min_element(rankTimes.begin(), rankTimes.end());
+	if (maxTime <= 0.0 || num_ranks == 1) return false;
+	double measuredImbalance = (maxTime - minTime) * 100.0 / maxTime;
+	L_INFO("Measured load imbalance of " + std::to_string(measuredImbalance) + "%.", GridUtils::logfile);
+	if (measuredImbalance < L_MPI_BALANCE_THRESHOLD) return false;
+
+	// BFL bodies store site-specific data which is not migrated
+	ObjectManager *objman = ObjectManager::getInstance();
+	int hasBFL = (objman->pBody.size() > 0) ? 1 : 0;
+	int anyBFL = 0;
+	MPI_Allreduce(&hasBFL, &anyBFL, 1, MPI_INT, MPI_MAX, world_comm);
+	if (anyBFL)
+	{
+		L_WARN("Dynamic load balancing does not support BFL bodies. Decomposition unchanged.", GridUtils::logfile);
+		return false;
+	}
+
+	// Compute the time per unit cost of each rank from the measured time
+	double dh = L_COARSE_SITE_WIDTH;
+	double bounds[6];
+	balance_weight_edges = rank_core_edge;
+	balance_rank_weights.assign(num_ranks, 0.0);
+	for (int rank = 0; rank < num_ranks; ++rank)
+	{
+		for (int e = eXMin; e <= eZMax; ++e) bounds[e] = rank_core_edge[e][rank];
+		double cost = grid_man->getActiveCellCost(&bounds[0]);
+		if (cost > 0.0) balance_rank_weights[rank] = rankTimes[rank] / cost;
+	}
+
+	// Store current decomposition in case the new one is rejected
+	std::vector<int> oldSizeX(cRankSizeX);
+	std::vector<int> oldSizeY(cRankSizeY);
+	std::vector<int> oldSizeZ(cRankSizeZ);
+	std::vector< std::vector<double> > oldEdges(rank_core_edge);
+
+	// Search for a decomposition which balances the weighted cost
+	mpi_SDBuildCostTable(dh);
+#ifdef L_MPI_RCB
+	double predictedImbalance = mpi_rcbDecompose(dh);
+#else
+	double predictedImbalance = mpi_smartDecompose(dh).loadImbalance;
+	MPI_Bcast(&predictedImbalance, 1, MPI_DOUBLE, 0, world_comm);
+#endif
+	balance_rank_weights.clear();
+	sd_cost_table.clear();
+
+	// Reject if no change or no improvement expected
+	if ((cRankSizeX == oldSizeX && cRankSizeY == oldSizeY && cRankSizeZ == oldSizeZ && rank_core_edge == oldEdges) ||
+		predictedImbalance >= measuredImbalance)
+	{
+		cRankSizeX = oldSizeX;
+		cRankSizeY = oldSizeY;
+		cRankSizeZ = oldSizeZ;
+		rank_core_edge = oldEdges;
+		L_INFO("No better decomposition found. Decomposition unchanged.", GridUtils::logfile);
+		return false;
+	}
+
+	// Apply new block geometry
+	mpi_setBlockGeometry(grid_man);
+
+	// Build new hierarchy on the new blocks
+	GridObj *oldGrids = grid_man->Grids;
+	GridObj *newGrids = new GridObj(0);
+	if (L_NUM_LEVELS != 0)
+	{
+		for (int reg = 0; reg < L_NUM_REGIONS; reg++)
+			newGrids->LBM_addSubGrid(reg);
+	}
+
+	// Check whether the set of grids on this rank has changed
+	int veto[2] = { 0, 0 };
+	for (int lev = 1; lev <= L_NUM_LEVELS; lev++)
+	{
+		for (int reg = 0; reg < L_NUM_REGIONS; reg++)
+		{
+			GridObj *gOld = nullptr, *gNew = nullptr;
+			GridUtils::getGrid(oldGrids, lev, reg, gOld);
+			GridUtils::getGrid(newGrids, lev, reg, gNew);
+			if ((gOld == nullptr) != (gNew == nullptr)) veto[0] = 1;
+		}
+	}
+	for (size_t ib = 0; ib < objman->iBody.size(); ib++)
+	{
+		if (objman->iBody[ib].level > 0) veto[1] = 1;
+	}
+	int vetoAll[2];
+	MPI_Allreduce(&veto[0], &vetoAll[0], 2, MPI_INT, MPI_MAX, world_comm);
+
+	// Revert if IB bodies would lose or gain their grid on a rank
+	if (vetoAll[0] && vetoAll[1])
+	{
+		delete newGrids;
+		cRankSizeX = oldSizeX;
+		cRankSizeY = oldSizeY;
+		cRankSizeZ = oldSizeZ;
+		rank_core_edge = oldEdges;
+		mpi_setBlockGeometry(grid_man);
+		L_WARN("New decomposition changes the sub-grids present on a rank with IB bodies on sub-grids. Decomposition unchanged.",
+			GridUtils::logfile);
+		return false;
+	}
+
+	// Move lattice data onto the new hierarchy
+	mpi_migrateGridData(oldGrids, newGrids, oldEdges);
+
+	// Point bodies at their grid in the new hierarchy
+	for (size_t ib = 0; ib < objman->iBody.size(); ib++)
+	{
+		GridObj *g = nullptr;
+		GridUtils::getGrid(newGrids, objman->iBody[ib].level, objman->iBody[ib]._Owner->region_number, g);
+		objman->iBody[ib]._Owner = g;
+	}
+
+	// Replace the hierarchy
+	grid_man->setGridHierarchy(newGrids);
+	objman->_Grids = newGrids;
+	delete oldGrids;
+
+	// Rebuild buffer information
+	buffer_send_info.clear();
+	buffer_recv_info.clear();
+	mpi_buffer_size();
+
+	// Rebuild writable data and sub-grid communicators
+	for (int reg = 0; reg < L_NUM_REGIONS; reg++)
+	{
+		for (int lev = 1; lev <= L_NUM_LEVELS; lev++)
+		{
+			if (subGrid_comm[(lev - 1) + reg * L_NUM_LEVELS] != MPI_COMM_NULL)
+				MPI_Comm_free(&subGrid_comm[(lev - 1) + reg * L_NUM_LEVELS]);
+		}
+	}
+	grid_man->p_data.clear();
+	mpi_buildCommunicators(grid_man);
+
+	// Rebuild level communicators
+	for (size_t lev = 0; lev < lev_comm.size(); lev++)
+	{
+		if (lev_comm[lev] != MPI_COMM_NULL) MPI_Comm_free(&lev_comm[lev]);
+	}
+	mpi_setSubGridDepth();
+
+	// Redistribute markers and rebuild the IBM support of the bodies affected
+#ifdef L_IBM_ON
+	std::vector<int> changed = mpi_migrateMarkers(oldEdges);
+	objman->ibm_reinitialise(changed);
+#endif
+
+	// Update load information
+	mpi_updateLoadInfo(grid_man);
+
+	L_INFO("Domain re-decomposed. Predicted imbalance of " + std::to_string(predictedImbalance) +
+		"% (measured " + std::to_string(measuredImbalance) + "%).", GridUtils::logfile);
+
+	return true;
+}
+
+// ************************************************************************* //
+/// \brief	Check whether a range of positions reaches the local grid of a rank.
+///
+///			Tests one direction using the current core edges and includes 
+///			the halo accounting for periodic wrapping. Pass the same value 
+///			for both ends to test a single position.
+///
+///	\param	lo		start of the range.
+///	\param	hi		end of the range.
+///	\param	dir		direction of the range.
+///	\param	rank	rank to check.
+///	\returns		true if the range touches the local grid of the rank.
+bool MpiManager::mpi_overlapsLocalBlock(double lo, double hi, int dir, int rank)
+{
+	// Whole domain in this direction if no halo
+	if (!mpi_hasHalo(dir, rank)) return true;
+
+	// Local grid extent including halo
+	double dh = L_COARSE_SITE_WIDTH;
+	double blockLo = rank_core_edge[2 * dir][rank] - L_MPI_HALO_DEPTH * dh;
+	double blockHi = rank_core_edge[2 * dir + 1][rank] + L_MPI_HALO_DEPTH * dh;
+	double L = GridManager::getInstance()->global_edges[2 * dir + 1][0];
+
+	// Check the range and its periodic images
+	for (int image = -1; image <= 1; image++)
+	{
+		if (lo + image * L < blockHi && hi + image * L >= blockLo) return true;
+	}
+	return false;
+}
+
+// ************************************************************************* //
+/// \brief	Move the lattice data from the old to the new decomposition.
+///
+///			Each rank sends the core sites of every grid it owns to the ranks 
+///			whose new local grid overlaps its old core. The sites sent to each 
+///			rank are found one direction at a time so only the sites in the 
+///			overlap are visited. The receiving rank places the data on the 
+///			matching sites of its new grid, whose local indices follow from 
+///			the global index of the site and the start of its position vectors.
+///
+///	\param	oldGrids	pointer to the hierarchy built on the old decomposition.
+///	\param	newGrids	pointer to the hierarchy built on the new decomposition.
+///	\param	oldEdges	rank core edges of the old decomposition.
+void MpiManager::mpi_migrateGridData(GridObj* const oldGrids, GridObj* const newGrids,
+	std::vector< std::vector<double> >& oldEdges)
+{
+	GridManager *gm = GridManager::getInstance();
+
+	// Size of a site record: level, region, position then data
+	const int recordSize = 5 + 2 * L_NUM_VELS + 2 * L_DIMS + 2 + 1 + L_DIMS + (3 * L_DIMS - 3);
+
+	// Ranks whose new local grid overlaps the old core of this rank
+	std::vector<int> toRanks;
+	for (int rank = 0; rank < num_ranks; rank++)
+	{
+		bool overlap = true;
+		for (int d = 0; d < L_DIMS && overlap; d++)
+			overlap = mpi_overlapsLocalBlock(oldEdges[2 * d][my_rank], oldEdges[2 * d + 1][my_rank], d, rank);
+		if (overlap) toRanks.push_back(rank);
+	}
+
+	// Pack the core sites of each old grid which lie on each destination
+	std::vector< std::vector<double> > sendBuffers(toRanks.size());
+	for (int lev = 0; lev <= L_NUM_LEVELS; lev++)
+	{
+		for (int reg = 0; reg < L_NUM_REGIONS; reg++)
+		{
+			GridObj *g = nullptr;
+			GridUtils::getGrid(oldGrids, lev, reg, g);
+			if (g == nullptr) continue;
+
+			std::vector<double> *pos[3] = { &g->XPos, &g->YPos, &g->ZPos };
+			int lims[3] = { g->N_lim, g->M_lim, g->K_lim };
+			for (size_t n = 0; n < toRanks.size(); n++)
+			{
+				// Indices in each direction in the old core and on the destination
+				std::vector<int> sites[3];
+				for (int d = 0; d < 3; d++)
+				{
+					for (int i = 0; i < lims[d]; i++)
+					{
+						double x = (*pos[d])[i];
+						if (d < L_DIMS && (x < oldEdges[2 * d][my_rank] || x >= oldEdges[2 * d + 1][my_rank] ||
+							!mpi_overlapsLocalBlock(x, x, d, toRanks[n]))) continue;
+						sites[d].push_back(i);
+					}
+				}
+
+				std::vector<double>& buf = sendBuffers[n];
+				for (int i : sites[eXDirection])
+				{
+					for (int j : sites[eYDirection])
+					{
+						for (int k : sites[eZDirection])
+						{
+							int id = k + j * g->K_lim + i * g->K_lim * g->M_lim;
+							buf.push_back(static_cast<double>(lev));
+							buf.push_back(static_cast<double>(reg));
+							buf.push_back(g->XPos[i]);
+							buf.push_back(g->YPos[j]);
+							buf.push_back(g->ZPos[k]);
+							for (int v = 0; v < L_NUM_VELS; v++) buf.push_back(g->f[v + id * L_NUM_VELS]);
+							for (int v = 0; v < L_NUM_VELS; v++) buf.push_back(g->fNew[v + id * L_NUM_VELS]);
+							for (int d = 0; d < L_DIMS; d++) buf.push_back(g->u[d + id * L_DIMS]);
+							for (int d = 0; d < L_DIMS; d++)
+								buf.push_back(g->force_xyz.empty() ? 0.0 : g->force_xyz[d + id * L_DIMS]);
+							buf.push_back(g->rho[id]);
+							buf.push_back(static_cast<double>(g->LatTyp[id]));
+
+							// Time-averaged quantities are not allocated on all grids
+							buf.push_back(g->rho_timeav.empty() ? 0.0 : g->rho_timeav[id]);
+							for (int d = 0; d < L_DIMS; d++)
+								buf.push_back(g->ui_timeav.empty() ? 0.0 : g->ui_timeav[d + id * L_DIMS]);
+							for (int d = 0; d < 3 * L_DIMS - 3; d++)
+								buf.push_back(g->uiuj_timeav.empty() ? 0.0 : g->uiuj_timeav[d + id * (3 * L_DIMS - 3)]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// Exchange with the overlapping ranks only
+	std::vector<int> fromRanks;
+	std::vector< std::vector<double> > recvBuffers;
+	mpi_sparseExchange(world_comm, 2, toRanks, sendBuffers, fromRanks, recvBuffers);
+	std::vector< std::vector<double> >().swap(sendBuffers);
+
+	/* Local index of the first site and number of sites of the whole grid in 
+	 * each direction. The position vectors run in steps of dh from their first 
+	 * site, wrapping at the edge of the grid, so a site with global index n 
+	 * sits at local index (n - start) modulo the grid size and every whole 
+	 * grid size after that which is still on the local grid. */
+	std::vector<GridObj*> newGridList((L_NUM_LEVELS + 1) * L_NUM_REGIONS, nullptr);
+	std::vector< std::vector<int> > start((L_NUM_LEVELS + 1) * L_NUM_REGIONS, std::vector<int>(3, 0));
+	std::vector< std::vector<int> > period((L_NUM_LEVELS + 1) * L_NUM_REGIONS, std::vector<int>(3, 1));
+	for (int lev = 0; lev <= L_NUM_LEVELS; lev++)
+	{
+		for (int reg = 0; reg < L_NUM_REGIONS; reg++)
+		{
+			int idx = lev + reg * (L_NUM_LEVELS + 1);
+			GridUtils::getGrid(newGrids, lev, reg, newGridList[idx]);
+			GridObj *g = newGridList[idx];
+			if (g == nullptr) continue;
+
+			int gmIdx = (lev == 0) ? 0 : lev + reg * L_NUM_LEVELS;
+			std::vector<double> *pos[3] = { &g->XPos, &g->YPos, &g->ZPos };
+			for (int d = 0; d < L_DIMS; d++)
+			{
+				start[idx][d] = static_cast<int>(std::floor((*pos[d])[0] / g->dh));
+				period[idx][d] = gm->global_size[d][gmIdx];
+			}
+		}
+	}
+
+	// Unpack into the new grids
+	for (size_t n = 0; n < recvBuffers.size(); n++)
+	{
+		int numRecords = static_cast<int>(recvBuffers[n].size()) / recordSize;
+		for (int r = 0; r < numRecords; r++)
+		{
+			const double *rec = &recvBuffers[n][r * recordSize];
+			int lev = static_cast<int>(rec[0]);
+			int reg = static_cast<int>(rec[1]);
+			int idx = lev + reg * (L_NUM_LEVELS + 1);
+			GridObj *g = newGridList[idx];
+			if (g == nullptr) continue;
+
+			// First local index of the site in each direction
+			int lims[3] = { g->N_lim, g->M_lim, g->K_lim };
+			int first[3] = { 0, 0, 0 };
+			for (int d = 0; d < L_DIMS; d++)
+			{
+				int offset = static_cast<int>(std::floor(rec[2 + d] / g->dh)) - start[idx][d];
+				first[d] = ((offset % period[idx][d]) + period[idx][d]) % period[idx][d];
+			}
+
+			// Copy data to every copy of the site on the local grid
+			for (int i = first[eXDirection]; i < lims[eXDirection]; i += period[idx][eXDirection])
+			{
+				for (int j = first[eYDirection]; j < lims[eYDirection]; j += period[idx][eYDirection])
+				{
+					for (int k = first[eZDirection]; k < lims[eZDirection]; k += period[idx][eZDirection])
+					{
+						int id = k + j * g->K_lim + i * g->K_lim * g->M_lim;
+						const double *val = rec + 5;
+						for (int v = 0; v < L_NUM_VELS; v++) g->f[v + id * L_NUM_VELS] = *val++;
+						for (int v = 0; v < L_NUM_VELS; v++) g->fNew[v + id * L_NUM_VELS] = *val++;
+						for (int d = 0; d < L_DIMS; d++) g->u[d + id * L_DIMS] = *val++;
+						for (int d = 0; d < L_DIMS; d++, val++)
+							if (!g->force_xyz.empty()) g->force_xyz[d + id * L_DIMS] = *val;
+						g->rho[id] = *val++;
+						g->LatTyp[id] = static_cast<eType>(static_cast<int>(*val++));
+						if (!g->rho_timeav.empty()) g->rho_timeav[id] = *val;
+						val++;
+						for (int d = 0; d < L_DIMS; d++, val++)
+							if (!g->ui_timeav.empty()) g->ui_timeav[d + id * L_DIMS] = *val;
+						for (int d = 0; d < 3 * L_DIMS - 3; d++, val++)
+							if (!g->uiuj_timeav.empty()) g->uiuj_timeav[d + id * (3 * L_DIMS - 3)] = *val;
+					}
+				}
+			}
+		}
+	}
+
+	// Carry over time step counters and timings
+	for (int lev = 0; lev <= L_NUM_LEVELS; lev++)
+	{
+		for (int reg = 0; reg < L_NUM_REGIONS; reg++)
+		{
+			GridObj *gNew = newGridList[lev + reg * (L_NUM_LEVELS + 1)];
+			if (gNew == nullptr) continue;
+
+			GridObj *gOld = nullptr;
+			GridUtils::getGrid(oldGrids, lev, reg, gOld);
+			if (gOld)
+			{
+				gNew->t = gOld->t;
+				gNew->timeav_timestep = gOld->timeav_timestep;
+				gNew->timeav_mpi_overhead = gOld->timeav_mpi_overhead;
+			}
+			else
+			{
+				gNew->t = oldGrids->t * static_cast<int>(pow(2, lev));
+			}
+		}
+	}
+}
+
+// ************************************************************************* //
+/// \brief	Move IB markers onto the ranks of the new decomposition.
+///
+///			A body is left untouched if none of its markers changes rank and 
+///			none of the ranks holding its markers or support sites changed 
+///			block, as its supports are then still valid. For every other body 
+///			the owning rank, which holds all its markers, reassigns the rank of 
+///			each marker from the new core edges and sends the marker data to 
+///			that rank. ds and epsilon do not depend on the decomposition so 
+///			they are sent with the marker. Non-owning ranks rebuild the marker 
+///			lists of these bodies from what they receive.
+///
+///	\param	oldEdges	rank core edges of the old decomposition.
+///	\returns			flag for each body ID set if its support must be rebuilt.
+std::vector<int> MpiManager::mpi_migrateMarkers(std::vector< std::vector<double> >& oldEdges)
+{
+	ObjectManager *objman = ObjectManager::getInstance();
+
+	// Body ID, marker ID, position, initial position, velocity, ds, epsilon
+	const int recordSize = 2 + 3 * 3 + 2;
+
+	// Ranks whose block has changed
+	std::vector<bool> moved(num_ranks, false);
+	for (int rank = 0; rank < num_ranks; rank++)
+	{
+		for (int e = eXMin; e <= eZMax; e++)
+		{
+			if (rank_core_edge[e][rank] != oldEdges[e][rank]) moved[rank] = true;
+		}
+	}
+
+	// Flag the bodies whose markers or support sites are affected
+	std::vector<int> changed(objman->bodyIDToIdx.size(), 0);
+	for (size_t ib = 0; ib < objman->iBody.size(); ib++)
+	{
+		IBBody &body = objman->iBody[ib];
+		for (auto m : body.validMarkers)
+		{
+			if (moved[my_rank]) changed[body.id] = 1;
+			for (size_t s = 0; s < body.markers[m].support_rank.size(); s++)
+			{
+				if (moved[body.markers[m].support_rank[s]]) changed[body.id] = 1;
+			}
+		}
+		if (body.owningRank == my_rank)
+		{
+			for (size_t m = 0; m < body.markers.size(); m++)
+			{
+				if (GridUtils::getRankfromPosition(body.markers[m].position) != body.markers[m].owningRank)
+					changed[body.id] = 1;
+			}
+		}
+	}
+	MPI_Allreduce(MPI_IN_PLACE, changed.data(), static_cast<int>(changed.size()), MPI_INT, MPI_MAX, world_comm);
+
+	// Owning ranks pack the markers of changed bodies which now belong to other ranks
+	std::vector<int> toRanks;
+	std::vector<int> toIdx(num_ranks, -1);
+	std::vector< std::vector<double> > sendBuffers;
+	for (size_t ib = 0; ib < objman->iBody.size(); ib++)
+	{
+		IBBody &body = objman->iBody[ib];
+		if (body.owningRank != my_rank || !changed[body.id]) continue;
+
+		for (size_t m = 0; m < body.markers.size(); m++)
+		{
+			// Support is found again from scratch
+			body.markers[m].supportCage.clear();
+
+			body.markers[m].owningRank = GridUtils::getRankfromPosition(body.markers[m].position);
+			int toRank = body.markers[m].owningRank;
+			if (toRank == my_rank) continue;
+
+			if (toIdx[toRank] < 0)
+			{
+				toIdx[toRank] = static_cast<int>(toRanks.size());
+				toRanks.push_back(toRank);
+				sendBuffers.emplace_back();
+			}
+			std::vector<double> &buf = sendBuffers[toIdx[toRank]];
+			buf.push_back(static_cast<double>(body.id));
+			buf.push_back(static_cast<double>(body.markers[m].id));
+			for (int d = 0; d < 3; d++) buf.push_back(body.markers[m].position[d]);
+			for (int d = 0; d < 3; d++) buf.push_back(body.markers[m].position0[d]);
+			for (int d = 0; d < 3; d++) buf.push_back(body.markers[m].markerVel[d]);
+			buf.push_back(body.markers[m].ds);
+			buf.push_back(body.markers[m].epsilon);
+		}
+	}
+
+	// Exchange with the new marker owners only
+	std::vector<int> fromRanks;
+	std::vector< std::vector<double> > recvBuffers;
+	mpi_sparseExchange(world_comm, 3, toRanks, sendBuffers, fromRanks, recvBuffers);
+
+	// Non-owning ranks clear the markers of changed bodies
+	for (size_t ib = 0; ib < objman->iBody.size(); ib++)
+	{
+		if (objman->iBody[ib].owningRank != my_rank && changed[objman->iBody[ib].id])
+			objman->iBody[ib].markers.clear();
+	}
+
+	// Rebuild markers from those received (arrive in ID order for each body)
+	for (size_t n = 0; n < recvBuffers.size(); n++)
+	{
+		int numRecords = static_cast<int>(recvBuffers[n].size()) / recordSize;
+		for (int r = 0; r < numRecords; r++)
+		{
+			const double *rec = &recvBuffers[n][r * recordSize];
+			IBBody &body = objman->iBody[objman->bodyIDToIdx[static_cast<int>(rec[0])]];
+			body.addMarker(rec[2], rec[3], rec[4], static_cast<int>(rec[1]));
+			for (int d = 0; d < 3; d++)
+			{
+				body.markers.back().position0[d] = rec[5 + d];
+				body.markers.back().markerVel[d] = rec[8 + d];
+			}
+			body.markers.back().ds = rec[11];
+			body.markers.back().epsilon = rec[12];
+		}
+	}
+
+	// Update valid markers
+	for (size_t ib = 0; ib < objman->iBody.size(); ib++)
+	{
+		if (changed[objman->iBody[ib].id]) objman->iBody[ib].getValidMarkers();
+	}
+
+	return changed;
+}
@@ -27,177 +27,92 @@
 
 
 // *****************************************************************************
-///	\brief	Do communication required for spreading to off-rank support points
+///	\brief	Start communication required for spreading to off-rank support points
+///
+///			Packs the spread force of every off-rank support site into one 
+///			message per rank and posts it. The incoming forces are unpacked 
+///			by ObjectManager::ibm_spreadOffRankForces once they are needed.
 ///
 ///	\param	level			current grid level
-///	\param	spreadForces	forces that have been spread
-void MpiManager::mpi_spreadComm(int level, std::vector<std::vector<double>> &spreadForces) {
+void MpiManager::mpi_spreadCommStart(int level) {
 
 	// Get object manager instance
 	ObjectManager *objman = ObjectManager::getInstance();
 
-	// Declare values
-	int toRank, ib , m, s;
-	std::vector<std::vector<double>> sendForce(num_ranks, std::vector<double>(0));
+	// Size the send buffer from the cached layout
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	const IBCommLayoutStruct &layout = plan.supportMarkerSide;
+	plan.sendBuffer.resize(layout.offset.back() * L_DIMS);
 
-	// Pack and send data first
-	for (int i = 0; i < supportCommMarkerSide[level].size(); i++) {
+	// Pack the data into the block of the rank which owns each support site
+	int ib, m, s;
+	for (size_t i = 0; i < supportCommMarkerSide[level].size(); i++) {
 
-		// Get body index
+		// Get IDs of support site
 		ib = objman->bodyIDToIdx[supportCommMarkerSide[level][i].bodyID];
+		m = supportCommMarkerSide[level][i].markerIdx;
+		s = supportCommMarkerSide[level][i].supportID;
 
-		// Only pack if body belongs to current grid level
-		if (objman->iBody[ib]._Owner->level == level) {
-
-			// Get rank to send to and support ID info
-			toRank = supportCommMarkerSide[level][i].rankComm;
-			m = supportCommMarkerSide[level][i].markerIdx;
-			s = supportCommMarkerSide[level][i].supportID;
-
-			// Get volume scaling
-			double volWidth = objman->iBody[ib].markers[m].epsilon;
-			double volDepth = 1.0;
+		// Get volume scaling
+		double volWidth = objman->iBody[ib].markers[m].epsilon;
+		double volDepth = 1.0;
 #if (L_DIMS == 3)
-			volDepth = objman->iBody[ib].markers[m].ds;
+		volDepth = objman->iBody[ib].markers[m].ds;
 #endif
 
-			// Pack into buffer
-			for (int dir = 0; dir < L_DIMS; dir++) {
-				sendForce[toRank].push_back(objman->iBody[ib].markers[m].deltaval[s] * objman->iBody[ib].markers[m].force_xyz[dir] *
-						volWidth * volDepth * objman->iBody[ib].markers[m].ds);
-			}
-		}
-	}
-
-	// Now send the values
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-
-		// Check if current rank needs to send stuff to rank toRank
-		if (sendForce[toRank].size() > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&sendForce[toRank].front(), static_cast<int>(sendForce[toRank].size()),
-				MPI_DOUBLE, toRank, my_rank, world_comm, &sendRequests.back());
-		}
-	}
-
-	// Get receive sizes from each rank
-	std::vector<int> bufferSize(num_ranks, 0);
-	for (int i = 0; i < supportCommSupportSide[level].size(); i++) {
-		if (objman->iBody[objman->bodyIDToIdx[supportCommSupportSide[level][i].bodyID]]._Owner->level == level)
-			bufferSize[supportCommSupportSide[level][i].rankComm] += L_DIMS;
-	}
-
-	// Now receive the velocity values
-	spreadForces.resize(num_ranks, std::vector<double>(0));
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
-
-		// If there is data to receive from rank fromRank
-		if (bufferSize[fromRank] > 0) {
-			spreadForces[fromRank].resize(bufferSize[fromRank]);
-			MPI_Recv(&spreadForces[fromRank].front(), static_cast<int>(spreadForces[fromRank].size()),
-				MPI_DOUBLE, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
+		// Pack into buffer
+		double *buf = &plan.sendBuffer[layout.slot[i] * L_DIMS];
+		for (int dir = 0; dir < L_DIMS; dir++) {
+			buf[dir] = objman->iBody[ib].markers[m].deltaval[s] * objman->iBody[ib].markers[m].force_xyz[dir] *
+					volWidth * volDepth * objman->iBody[ib].markers[m].ds;
 		}
 	}
 
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
+	// Post the messages
+	mpi_startIBMComm(level, plan.supportMarkerSide, plan.supportSide, L_DIMS);
 }
 
 
 // *****************************************************************************
-///	\brief	Do communication required for interpolating from off-rank support points
+///	\brief	Start communication required for interpolating from off-rank support points
+///
+///			Packs the density and momentum of every support site this rank 
+///			owns for off-rank markers into one message per rank and posts it.
+///			The incoming values are unpacked by 
+///			ObjectManager::ibm_interpolateOffRankVels once they are needed.
 ///
 ///	\param	level			current grid level
-///	\param	recvVel			velocities that have been interpolated
-void MpiManager::mpi_interpolateComm(int level, std::vector<std::vector<double>> &recvVel) {
+void MpiManager::mpi_interpolateCommStart(int level) {
 
 	// Get object manager instance
 	ObjectManager *objman = ObjectManager::getInstance();
 
-	// Declare values
-	int toRank, ib;
-	std::vector<int> idx(3, 0);
-	std::vector<std::vector<double>> sendVel(num_ranks, std::vector<double>(0));
+	// Size the send buffer from the cached layout
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	const IBCommLayoutStruct &layout = plan.supportSide;
+	plan.sendBuffer.resize(layout.offset.back() * (L_DIMS + 1));
 
-	// Pack and send data first
-	for (int i = 0; i < supportCommSupportSide[level].size(); i++) {
+	// Pack the data into the block of the rank which owns each marker
+	int ib, id;
+	for (size_t i = 0; i < supportCommSupportSide[level].size(); i++) {
 
-		// Get body ID
+		// Get body index and grid
 		ib = objman->bodyIDToIdx[supportCommSupportSide[level][i].bodyID];
+		GridObj *g = objman->iBody[ib]._Owner;
 
-		// Only pack if body belongs to current grid level
-		if (objman->iBody[ib]._Owner->level == level) {
-
-			// Get rank to send to
-			toRank = supportCommSupportSide[level][i].rankComm;
-
-			// Get grid sizes
-			size_t M_lim = objman->iBody[ib]._Owner->M_lim;
-#if (L_DIMS == 3)
-			size_t K_lim = objman->iBody[ib]._Owner->K_lim;
-#endif
-
-			// Get indices
-			idx = supportCommSupportSide[level][i].supportIdx;
-
-			// Pack density and momentum into buffer
-#if (L_DIMS == 2)
-			sendVel[toRank].push_back(objman->iBody[ib]._Owner->rho(idx[eXDirection], idx[eYDirection], M_lim));
-
-			sendVel[toRank].push_back(objman->iBody[ib]._Owner->rho(idx[eXDirection], idx[eYDirection], M_lim) *
-									  objman->iBody[ib]._Owner->u(idx[eXDirection], idx[eYDirection], eXDirection, M_lim, L_DIMS));
-
-			sendVel[toRank].push_back(objman->iBody[ib]._Owner->rho(idx[eXDirection], idx[eYDirection], M_lim) *
-									  objman->iBody[ib]._Owner->u(idx[eXDirection], idx[eYDirection], eYDirection, M_lim, L_DIMS));
-#elif (L_DIMS == 3)
-			sendVel[toRank].push_back(objman->iBody[ib]._Owner->rho(idx[eXDirection], idx[eYDirection], idx[eZDirection], M_lim, K_lim));
-
-			sendVel[toRank].push_back(objman->iBody[ib]._Owner->rho(idx[eXDirection], idx[eYDirection], idx[eZDirection], M_lim, K_lim) *
-									  objman->iBody[ib]._Owner->u(idx[eXDirection], idx[eYDirection], idx[eZDirection], eXDirection, M_lim, K_lim, L_DIMS));
-
-			sendVel[toRank].push_back(objman->iBody[ib]._Owner->rho(idx[eXDirection], idx[eYDirection], idx[eZDirection], M_lim, K_lim) *
-									  objman->iBody[ib]._Owner->u(idx[eXDirection], idx[eYDirection], idx[eZDirection], eYDirection, M_lim, K_lim, L_DIMS));
-
-			sendVel[toRank].push_back(objman->iBody[ib]._Owner->rho(idx[eXDirection], idx[eYDirection], idx[eZDirection], M_lim, K_lim) *
-									  objman->iBody[ib]._Owner->u(idx[eXDirection], idx[eYDirection], idx[eZDirection], eZDirection, M_lim, K_lim, L_DIMS));
-#endif
-		}
-	}
-
-	// Now send the values
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-
-		// Check if current rank needs to send stuff to rank toRank
-		if (sendVel[toRank].size() > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&sendVel[toRank].front(), static_cast<int>(sendVel[toRank].size()),
-				MPI_DOUBLE, toRank, my_rank, world_comm, &sendRequests.back());
-		}
-	}
-
-	// Get receive sizes from each rank
-	std::vector<int> bufferSize(num_ranks, 0);
-	for (int i = 0; i < supportCommMarkerSide[level].size(); i++) {
-		if (objman->iBody[objman->bodyIDToIdx[supportCommMarkerSide[level][i].bodyID]]._Owner->level == level)
-			bufferSize[supportCommMarkerSide[level][i].rankComm] += L_DIMS + 1;
-	}
-
-	// Now receive the velocity values
-	recvVel.resize(num_ranks, std::vector<double>(0));
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
+		// Get grid site index
+		const std::vector<int> &idx = supportCommSupportSide[level][i].supportIdx;
+		id = idx[eZDirection] + idx[eYDirection] * g->K_lim + idx[eXDirection] * g->K_lim * g->M_lim;
 
-		// If there is data to receive from rank fromRank
-		if (bufferSize[fromRank] > 0) {
-			recvVel[fromRank].resize(bufferSize[fromRank]);
-			MPI_Recv(&recvVel[fromRank].front(), static_cast<int>(recvVel[fromRank].size()),
-				MPI_DOUBLE, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-		}
+		// Pack density and momentum into buffer
+		double *buf = &plan.sendBuffer[layout.slot[i] * (L_DIMS + 1)];
+		buf[0] = g->rho[id];
+		for (int dir = 0; dir < L_DIMS; dir++)
+			buf[dir + 1] = g->rho[id] * g->u[id * L_DIMS + dir];
 	}
 
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
+	// Post the messages
+	mpi_startIBMComm(level, plan.supportSide, plan.supportMarkerSide, L_DIMS + 1);
 }
 
 
@@ -210,72 +125,37 @@ void MpiManager::mpi_epsilonCommScatter(int level) {
 	// Get object manager instance
 	ObjectManager *objman = ObjectManager::getInstance();
 
-	// Declare send buffer
-	std::vector<std::vector<double>> sendBuffer(num_ranks, std::vector<double>(0));
+	// Size the send buffer from the cached layout
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	plan.sendBuffer.resize(plan.ownerSide.offset.back());
 
-	// Pack and send the other epsilon values
-	int toRank, ib, markerID;
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++) {
+	// Pack the epsilon values
+	int ib, markerID;
+	for (size_t i = 0; i < markerCommOwnerSide[level].size(); i++) {
 
 		// Get ID info
-		toRank = markerCommOwnerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommOwnerSide[level][i].bodyID];
 		markerID = markerCommOwnerSide[level][i].markerID;
 
 		// Insert into buffer
-		sendBuffer[toRank].push_back(objman->iBody[ib].markers[markerID].epsilon);
-	}
-
-	// Loop through and post send if there is data
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-		if (sendBuffer[toRank].size() > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&sendBuffer[toRank].front(), static_cast<int>(sendBuffer[toRank].size()),
-				MPI_DOUBLE, toRank, my_rank, world_comm, &sendRequests.back());
-		}
-	}
-
-	// Set up receive buffer sizes
-	std::vector<int> bufferSize(num_ranks, 0);
-
-	// Size the receive buffer
-	for (int i = 0; i < markerCommMarkerSide[level].size(); i++)
-		bufferSize[markerCommMarkerSide[level][i].rankComm]++;
-
-	// Declare receive buffer
-	std::vector<std::vector<double>> recvBuffer(num_ranks, std::vector<double>(0));
-
-	// Loop through and receive if there is data
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
-
-		// Only do if there is information to receive
-		if (bufferSize[fromRank] > 0) {
-			recvBuffer[fromRank].resize(bufferSize[fromRank]);
-			MPI_Recv(&recvBuffer[fromRank].front(), static_cast<int>(recvBuffer[fromRank].size()),
-				MPI_DOUBLE, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-		}
+		plan.sendBuffer[plan.ownerSide.slot[i]] = objman->iBody[ib].markers[markerID].epsilon;
 	}
 
-	// Create idx vector
-	std::vector<int> idx(num_ranks, 0);
+	// Exchange the messages
+	mpi_startIBMComm(level, plan.ownerSide, plan.markerSide, 1);
+	mpi_finishIBMComm(level);
 
 	// Now unpack into epsilon values
-	int fromRank, markerIdx;
-	for (int i = 0; i < markerCommMarkerSide[level].size(); i++) {
+	int markerIdx;
+	for (size_t i = 0; i < markerCommMarkerSide[level].size(); i++) {
 
 		// Get ID info
-		fromRank = markerCommMarkerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommMarkerSide[level][i].bodyID];
 		markerIdx = markerCommMarkerSide[level][i].markerIdx;
 
 		// Put into epsilon
-		objman->iBody[ib].markers[markerIdx].epsilon = recvBuffer[fromRank][idx[fromRank]];
-		idx[fromRank]++;
+		objman->iBody[ib].markers[markerIdx].epsilon = plan.recvBuffer[plan.markerSide.slot[i]];
 	}
-
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
 }
 
 
@@ -288,66 +168,39 @@ void MpiManager::mpi_epsilonCommGather(int level) {
 	// Get object manager instance
 	ObjectManager *objman = ObjectManager::getInstance();
 
-	// Declare send buffer
-	std::vector<std::vector<double>> sendBuffer(num_ranks, std::vector<double>(0));
+	// Size the send buffer from the cached layout
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	plan.sendBuffer.resize(plan.markerSideSupports.offset.back());
 
 	// Pack the data to send
-	int toRank, ib, m;
-	for (int i = 0; i < markerCommMarkerSide[level].size(); i++) {
+	int ib, m;
+	for (size_t i = 0; i < markerCommMarkerSide[level].size(); i++) {
 
 		// Get ID info
-		toRank = markerCommMarkerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommMarkerSide[level][i].bodyID];
 		m = markerCommMarkerSide[level][i].markerIdx;
 
 		// Pack support data
-		for (int s = 0; s < objman->iBody[ib].markers[m].deltaval.size(); s++) {
-			sendBuffer[toRank].push_back(objman->iBody[ib].markers[m].supp_x[s]);
-			sendBuffer[toRank].push_back(objman->iBody[ib].markers[m].supp_y[s]);
+		double *buf = plan.sendBuffer.data() + plan.markerSideSupports.slot[i];
+		for (size_t s = 0; s < objman->iBody[ib].markers[m].deltaval.size(); s++) {
+			*buf++ = objman->iBody[ib].markers[m].supp_x[s];
+			*buf++ = objman->iBody[ib].markers[m].supp_y[s];
 #if (L_DIMS == 3)
-			sendBuffer[toRank].push_back(objman->iBody[ib].markers[m].supp_z[s]);
+			*buf++ = objman->iBody[ib].markers[m].supp_z[s];
 #endif
-			sendBuffer[toRank].push_back(objman->iBody[ib].markers[m].deltaval[s]);
-		}
-	}
-
-	// Now loop through send buffer and send to appropriate ranks
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-		if (sendBuffer[toRank].size() > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&sendBuffer[toRank].front(), static_cast<int>(sendBuffer[toRank].size()), MPI_DOUBLE, toRank, my_rank, world_comm, &sendRequests.back());
+			*buf++ = objman->iBody[ib].markers[m].deltaval[s];
 		}
 	}
 
-	// Get buffer sizes
-	std::vector<int> bufferSize(num_ranks, 0);
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++)
-		bufferSize[markerCommOwnerSide[level][i].rankComm] += markerCommOwnerSide[level][i].nSupportSites * (L_DIMS + 1);
-
-	// Now create receive buffer
-	std::vector<std::vector<double>> recvBuffer(num_ranks, std::vector<double>(0));
-
-	// Now loop through and receive the buffer
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
-
-		// Only do if there is information to receive
-		if (bufferSize[fromRank] > 0) {
-			recvBuffer[fromRank].resize(bufferSize[fromRank]);
-			MPI_Recv(&recvBuffer[fromRank].front(), static_cast<int>(recvBuffer[fromRank].size()),
-				MPI_DOUBLE, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-		}
-	}
-
-	// Index vector for looping through recvBuffer
-	std::vector<int> idx(num_ranks, 0);
+	// Exchange the messages
+	mpi_startIBMComm(level, plan.markerSideSupports, plan.ownerSideSupports, 1);
+	mpi_finishIBMComm(level);
 
 	// Now unpack
-	int fromRank, nSupports;
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++) {
+	int nSupports;
+	for (size_t i = 0; i < markerCommOwnerSide[level].size(); i++) {
 
 		// Get ID info
-		fromRank = markerCommOwnerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommOwnerSide[level][i].bodyID];
 		m = markerCommOwnerSide[level][i].markerID;
 		nSupports = markerCommOwnerSide[level][i].nSupportSites;
@@ -359,22 +212,18 @@ void MpiManager::mpi_epsilonCommGather(int level) {
 		objman->iBody[ib].markers[m].deltaval.resize(nSupports, 0.0);
 
 		// Unpack into iBody
+		const double *buf = plan.recvBuffer.data() + plan.ownerSideSupports.slot[i];
 		for (int s = 0; s < nSupports; s++) {
-			objman->iBody[ib].markers[m].supp_x[s] = recvBuffer[fromRank][idx[fromRank]];
-			objman->iBody[ib].markers[m].supp_y[s] = recvBuffer[fromRank][idx[fromRank]+1];
+			objman->iBody[ib].markers[m].supp_x[s] = *buf++;
+			objman->iBody[ib].markers[m].supp_y[s] = *buf++;
 #if (L_DIMS == 3)
-			objman->iBody[ib].markers[m].supp_z[s] = recvBuffer[fromRank][idx[fromRank]+2];
+			objman->iBody[ib].markers[m].supp_z[s] = *buf++;
 #endif
-			idx[fromRank] += L_DIMS;
 
 			// Get delta values
-			objman->iBody[ib].markers[m].deltaval[s] = recvBuffer[fromRank][idx[fromRank]];
-			idx[fromRank]++;
+			objman->iBody[ib].markers[m].deltaval[s] = *buf++;
 		}
 	}
-
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
 }
 
 
@@ -652,72 +501,37 @@ void MpiManager::mpi_uniEpsilonCommScatter(int level, int rootRank, IBBody &iBod
 		}
 	}
 
-	// Update owning rank's epsilon values
-	std::vector<std::vector<double>> sendEpsBuffer(num_ranks, std::vector<double>(0));
+	// Size the send buffer from the cached layout
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	plan.sendBuffer.resize(plan.markerSide.offset.back());
 
-	// Pack and send the other epsilon values
-	int toRank, ib, markerIdx;
-	for (int i = 0; i < markerCommMarkerSide[level].size(); i++) {
+	// Pack the epsilon values of markers owned by other ranks
+	int ib, markerIdx;
+	for (size_t i = 0; i < markerCommMarkerSide[level].size(); i++) {
 
 		// Get ID info
-		toRank = markerCommMarkerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommMarkerSide[level][i].bodyID];
 		markerIdx = markerCommMarkerSide[level][i].markerIdx;
 
 		// Insert into buffer
-		sendEpsBuffer[toRank].push_back(objman->iBody[ib].markers[markerIdx].epsilon);
-	}
-
-	// Loop through and post send if there is data
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-		if (sendEpsBuffer[toRank].size() > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&sendEpsBuffer[toRank].front(), static_cast<int>(sendEpsBuffer[toRank].size()),
-				MPI_DOUBLE, toRank, my_rank, world_comm, &sendRequests.back());
-		}
+		plan.sendBuffer[plan.markerSide.slot[i]] = objman->iBody[ib].markers[markerIdx].epsilon;
 	}
 
-	// Set up receive buffer sizes
-	std::vector<int> bufferSize(num_ranks, 0);
-
-	// Size the receive buffer
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++)
-		bufferSize[markerCommOwnerSide[level][i].rankComm]++;
-
-	// Declare receive buffer
-	std::vector<std::vector<double>> recvEpsBuffer(num_ranks, std::vector<double>(0));
-
-	// Loop through and receive if there is data
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
-
-		// Only do if there is information to receive
-		if (bufferSize[fromRank] > 0) {
-			recvEpsBuffer[fromRank].resize(bufferSize[fromRank]);
-			MPI_Recv(&recvEpsBuffer[fromRank].front(), static_cast<int>(recvEpsBuffer[fromRank].size()),
-				MPI_DOUBLE, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-		}
-	}
-
-	// Create idx vector
-	std::vector<int> idx(num_ranks, 0);
+	// Send them to the body owners
+	mpi_startIBMComm(level, plan.markerSide, plan.ownerSide, 1);
+	mpi_finishIBMComm(level);
 
 	// Now unpack into epsilon values
-	int fromRank, markerID;
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++) {
+	int markerID;
+	for (size_t i = 0; i < markerCommOwnerSide[level].size(); i++) {
 
 		// Get ID info
-		fromRank = markerCommOwnerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommOwnerSide[level][i].bodyID];
 		markerID = markerCommOwnerSide[level][i].markerID;
 
 		// Put into epsilon
-		objman->iBody[ib].markers[markerID].epsilon = recvEpsBuffer[fromRank][idx[fromRank]];
-		idx[fromRank]++;
+		objman->iBody[ib].markers[markerID].epsilon = plan.recvBuffer[plan.ownerSide.slot[i]];
 	}
-
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
 }
 
 
@@ -752,54 +566,48 @@ void MpiManager::mpi_buildMarkerComms(int level) {
 		}
 	}
 
-	// Send number of support sites
-	std::vector<std::vector<int>> sendBuffer(num_ranks, std::vector<int>(0));
+	// Cache the layouts of the marker-owner comms
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	std::vector<int> ranks, sizes;
+	for (size_t i = 0; i < markerCommOwnerSide[level].size(); i++)
+		ranks.push_back(markerCommOwnerSide[level][i].rankComm);
+	sizes.assign(ranks.size(), 1);
+	mpi_buildIBMCommLayout(plan.ownerSide, ranks, sizes);
+	ranks.clear();
+	for (size_t i = 0; i < markerCommMarkerSide[level].size(); i++)
+		ranks.push_back(markerCommMarkerSide[level][i].rankComm);
+	sizes.assign(ranks.size(), 1);
+	mpi_buildIBMCommLayout(plan.markerSide, ranks, sizes);
 
-	// Pack data
-	int toRank, ib, m;
-	for (int i = 0; i < markerCommMarkerSide[level].size(); i++) {
+	// Pack number of support sites
+	int ib, m;
+	plan.sendBuffer.resize(plan.markerSide.offset.back());
+	for (size_t i = 0; i < markerCommMarkerSide[level].size(); i++) {
 
 		// Get marker info
-		toRank = markerCommMarkerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommMarkerSide[level][i].bodyID];
 		m = markerCommMarkerSide[level][i].markerIdx;
 
-		// Pack into send buffer
-		sendBuffer[toRank].push_back(static_cast<int>(objman->iBody[ib].markers[m].deltaval.size()));
+		// Pack into send buffer and size the support data of this marker
+		sizes[i] = static_cast<int>(objman->iBody[ib].markers[m].deltaval.size());
+		plan.sendBuffer[plan.markerSide.slot[i]] = sizes[i];
+		sizes[i] *= L_DIMS + 1;
 	}
+	mpi_buildIBMCommLayout(plan.markerSideSupports, ranks, sizes);
 
-	// Now loop through and send to required ranks
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-		if (sendBuffer[toRank].size() > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&sendBuffer[toRank].front(), static_cast<int>(sendBuffer[toRank].size()),
-				MPI_INT, toRank, my_rank, world_comm, &sendRequests.back());
-		}
-	}
-
-	// Now create and size the receive buffer
-	std::vector<std::vector<int>> recvBuffer(num_ranks, std::vector<int>(0));
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++)
-		recvBuffer[markerCommOwnerSide[level][i].rankComm].push_back(0);
-
-	// Now loop through and receive
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
-		if (recvBuffer[fromRank].size() > 0) {
-			MPI_Recv(&recvBuffer[fromRank].front(), static_cast<int>(recvBuffer[fromRank].size()),
-				MPI_INT, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-		}
-	}
+	// Send them to the body owners
+	mpi_startIBMComm(level, plan.markerSide, plan.ownerSide, 1);
+	mpi_finishIBMComm(level);
 
 	// Now unpack
-	std::vector<int> idx(num_ranks, 0);
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++) {
-		markerCommOwnerSide[level][i].nSupportSites = recvBuffer[markerCommOwnerSide[level][i].rankComm][idx[markerCommOwnerSide[level][i].rankComm]];
-		idx[markerCommOwnerSide[level][i].rankComm]++;
-	}
-
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
+	ranks.clear();
+	sizes.clear();
+	for (size_t i = 0; i < markerCommOwnerSide[level].size(); i++) {
+		markerCommOwnerSide[level][i].nSupportSites = static_cast<int>(plan.recvBuffer[plan.ownerSide.slot[i]]);
+		ranks.push_back(markerCommOwnerSide[level][i].rankComm);
+		sizes.push_back(markerCommOwnerSide[level][i].nSupportSites * (L_DIMS + 1));
+	}
+	mpi_buildIBMCommLayout(plan.ownerSideSupports, ranks, sizes);
 }
 
 // *****************************************************************************
@@ -833,109 +641,131 @@ void MpiManager::mpi_buildSupportComms(int level) {
 		}
 	}
 
-	// Get how many supports site that need to be received from each rank
-	std::vector<int> nSupportToRecv(num_ranks, 0);
-	std::vector<int> nSupportToRecvLev(lev2glob.size(), 0);
-	for (int i = 0; i < supportCommMarkerSide[level].size(); i++) {
-		nSupportToRecv[supportCommMarkerSide[level][i].rankComm]++;
-		nSupportToRecvLev[glob2lev[supportCommMarkerSide[level][i].rankComm]]++;
-	}
-
-	// Do global comm so that each rank knows how many support sites to send and where
-	std::vector<int> nSupportToSend(num_ranks, 0);
-	std::vector<int> nSupportToSendLev(lev2glob.size(), 0);
-	MPI_Alltoall(&nSupportToRecvLev.front(), 1, MPI_INT, &nSupportToSendLev.front(), 1, MPI_INT, lev_comm[level]);
-
-	// Insert into full vector
-	for (int levRank = 0; levRank < lev2glob.size(); levRank++)
-		nSupportToSend[lev2glob[levRank]] = nSupportToSendLev[levRank];
+	// Cache the layout of the marker side so the support sites are grouped by owning rank
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	std::vector<int> ranks, sizes;
+	for (size_t i = 0; i < supportCommMarkerSide[level].size(); i++)
+		ranks.push_back(supportCommMarkerSide[level][i].rankComm);
+	sizes.assign(ranks.size(), 1);
+	mpi_buildIBMCommLayout(plan.supportMarkerSide, ranks, sizes);
 
-	// Declare variables for packing positions and body IDs
-	int ib, m, s, toRank;
-	std::vector<std::vector<double>> supportPositions(num_ranks, std::vector<double>(0));
-	std::vector<std::vector<int>> bodyIDs(num_ranks, std::vector<int>(0));
-
-	// Pack the positions of the support sites that need to be received into buffer
-	for (int i = 0; i < supportCommMarkerSide[level].size(); i++) {
+	// Pack the body ID and position of each support site into the message for the rank which owns it
+	int ib, m, s;
+	const IBCommLayoutStruct &layout = plan.supportMarkerSide;
+	std::vector<int> toRanks(layout.ranks.size());
+	std::vector<std::vector<double>> sendBuffers(layout.ranks.size());
+	for (size_t n = 0; n < layout.ranks.size(); n++) {
+		toRanks[n] = glob2lev[layout.ranks[n]];
+		sendBuffers[n].resize((layout.offset[n + 1] - layout.offset[n]) * (L_DIMS + 1));
+	}
+	for (size_t i = 0; i < supportCommMarkerSide[level].size(); i++) {
 
-		// Get IDs of support site
+		// Get IDs of support site and its place in the message
 		ib = objman->bodyIDToIdx[supportCommMarkerSide[level][i].bodyID];
 		m = supportCommMarkerSide[level][i].markerIdx;
 		s = supportCommMarkerSide[level][i].supportID;
-		toRank = supportCommMarkerSide[level][i].rankComm;
-
-		// Body ID
-		bodyIDs[toRank].push_back(supportCommMarkerSide[level][i].bodyID);
+		size_t n = std::lower_bound(layout.ranks.begin(), layout.ranks.end(), supportCommMarkerSide[level][i].rankComm) - layout.ranks.begin();
+		double *buf = &sendBuffers[n][(layout.slot[i] - layout.offset[n]) * (L_DIMS + 1)];
 
 		// Add to send buffer
-		supportPositions[toRank].push_back(objman->iBody[ib].markers[m].supp_x[s]);
-		supportPositions[toRank].push_back(objman->iBody[ib].markers[m].supp_y[s]);
+		buf[0] = supportCommMarkerSide[level][i].bodyID;
+		buf[1] = objman->iBody[ib].markers[m].supp_x[s];
+		buf[2] = objman->iBody[ib].markers[m].supp_y[s];
 #if (L_DIMS == 3)
-		supportPositions[toRank].push_back(objman->iBody[ib].markers[m].supp_z[s]);
+		buf[3] = objman->iBody[ib].markers[m].supp_z[s];
 #endif
 	}
 
-
-	// Loop through all sends that are required
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-
-		// Check if it has stuff to send to rank toRank
-		if (nSupportToRecv[toRank] > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&supportPositions[toRank].front(), static_cast<int>(supportPositions[toRank].size()),
-				MPI_DOUBLE, toRank, my_rank, world_comm, &sendRequests.back());
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&bodyIDs[toRank].front(), static_cast<int>(bodyIDs[toRank].size()),
-				MPI_INT, toRank, my_rank, world_comm, &sendRequests.back());
-		}
-	}
-
-	// Declare receive buffers
-	std::vector<std::vector<double>> supportPositionsRecv(num_ranks, std::vector<double>(0));
-	std::vector<std::vector<int>> bodyIDsRecv(num_ranks, std::vector<int>(0));
-
-	// Loop through all receives that are required
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
-
-		// Resize the buffer
-		supportPositionsRecv[fromRank].resize(nSupportToSend[fromRank] * L_DIMS);
-		bodyIDsRecv[fromRank].resize(nSupportToSend[fromRank]);
-
-		// Check if it has stuff to receive from rank i
-		if (nSupportToSend[fromRank] > 0) {
-			MPI_Recv(&supportPositionsRecv[fromRank].front(), static_cast<int>(supportPositionsRecv[fromRank].size()),
-				MPI_DOUBLE, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-			MPI_Recv(&bodyIDsRecv[fromRank].front(), static_cast<int>(bodyIDsRecv[fromRank].size()),
-				MPI_INT, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-		}
-	}
+	// Exchange with the owning ranks only (no rank needs to know in advance who will send to it)
+	std::vector<int> fromRanks;
+	std::vector<std::vector<double>> recvBuffers;
+	mpi_sparseExchange(lev_comm[level], 0, toRanks, sendBuffers, fromRanks, recvBuffers);
 
 	// Get enclosing voxel indices
 	double x, y, z;
 	std::vector<int> nearijk;
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
-		for (int i = 0; i < nSupportToSend[fromRank]; i++) {
+	for (size_t n = 0; n < fromRanks.size(); n++) {
+		for (size_t i = 0; i < recvBuffers[n].size(); i += L_DIMS + 1) {
 
 			// Unpack positions and body ID
-			ib = objman->bodyIDToIdx[bodyIDsRecv[fromRank][i]];
-			x = supportPositionsRecv[fromRank][i * L_DIMS];
-			y = supportPositionsRecv[fromRank][i * L_DIMS + 1];
+			int bodyID = static_cast<int>(recvBuffers[n][i]);
+			ib = objman->bodyIDToIdx[bodyID];
+			x = recvBuffers[n][i + 1];
+			y = recvBuffers[n][i + 2];
 			z = 0.0;
 #if (L_DIMS == 3)
-			z = supportPositionsRecv[fromRank][i * L_DIMS + 2];
+			z = recvBuffers[n][i + 3];
 #endif
 
 			// Get indices of enclosing voxel
 			GridUtils::getEnclosingVoxel(x, y, z, objman->iBody[ib]._Owner, &nearijk);
 
 			// Place in sending vector
-			supportCommSupportSide[level].emplace_back(fromRank, bodyIDsRecv[fromRank][i], nearijk);
+			supportCommSupportSide[level].emplace_back(lev2glob[fromRanks[n]], bodyID, nearijk);
 		}
 	}
 
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
+	// Cache the layout of the support side
+	ranks.clear();
+	for (size_t i = 0; i < supportCommSupportSide[level].size(); i++)
+		ranks.push_back(supportCommSupportSide[level][i].rankComm);
+	sizes.assign(ranks.size(), 1);
+	mpi_buildIBMCommLayout(plan.supportSide, ranks, sizes);
+}
+
+// *****************************************************************************
+///	\brief	Update the support comms of markers whose off-rank sites moved
+///
+///			Only valid when every support site is still owned by the same 
+///			rank so the cached layouts still hold. The support side only 
+///			recomputes the sites of the flagged markers.
+///
+///	\param	level			current grid level
+///	\param	moved			flags (one per marker of each body) of markers whose support moved
+void MpiManager::mpi_refreshSupportComms(int level, const std::vector<std::vector<bool>> &moved) {
+
+	// Get object manager instance
+	ObjectManager *objman = ObjectManager::getInstance();
+
+	// Size the send buffer from the cached layout
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	plan.sendBuffer.assign(plan.supportMarkerSide.offset.back() * (L_DIMS + 1), 0.0);
+
+	// Pack a flag and the position of the support sites of the moved markers
+	int ib, m, s;
+	for (size_t i = 0; i < supportCommMarkerSide[level].size(); i++) {
+
+		// Get IDs of support site
+		ib = objman->bodyIDToIdx[supportCommMarkerSide[level][i].bodyID];
+		m = supportCommMarkerSide[level][i].markerIdx;
+		s = supportCommMarkerSide[level][i].supportID;
+		if (moved[ib].empty() || !moved[ib][m]) continue;
+
+		// Add to send buffer
+		double *buf = &plan.sendBuffer[plan.supportMarkerSide.slot[i] * (L_DIMS + 1)];
+		buf[0] = 1.0;
+		buf[1] = objman->iBody[ib].markers[m].supp_x[s];
+		buf[2] = objman->iBody[ib].markers[m].supp_y[s];
+#if (L_DIMS == 3)
+		buf[3] = objman->iBody[ib].markers[m].supp_z[s];
+#endif
+	}
+
+	// Exchange the messages
+	mpi_startIBMComm(level, plan.supportMarkerSide, plan.supportSide, L_DIMS + 1);
+	mpi_finishIBMComm(level);
+
+	// Get the new enclosing voxel of the flagged sites
+	double z = 0.0;
+	for (size_t i = 0; i < supportCommSupportSide[level].size(); i++) {
+		const double *buf = &plan.recvBuffer[plan.supportSide.slot[i] * (L_DIMS + 1)];
+		if (buf[0] == 0.0) continue;
+		ib = objman->bodyIDToIdx[supportCommSupportSide[level][i].bodyID];
+#if (L_DIMS == 3)
+		z = buf[3];
+#endif
+		GridUtils::getEnclosingVoxel(buf[1], buf[2], z, objman->iBody[ib]._Owner, &supportCommSupportSide[level][i].supportIdx);
+	}
 }
 
 
@@ -948,72 +778,120 @@ void MpiManager::mpi_dsCommScatter(int level) {
 	// Get object manager instance
 	ObjectManager *objman = ObjectManager::getInstance();
 
-	// Declare send buffer
-	std::vector<std::vector<double>> sendBuffer(num_ranks, std::vector<double>(0));
+	// Size the send buffer from the cached layout
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	plan.sendBuffer.resize(plan.ownerSide.offset.back());
 
-	// Pack and send the other epsilon values
-	int toRank, ib, markerID;
-	for (int i = 0; i < markerCommOwnerSide[level].size(); i++) {
+	// Pack the ds values
+	int ib, markerID;
+	for (size_t i = 0; i < markerCommOwnerSide[level].size(); i++) {
 
 		// Get ID info
-		toRank = markerCommOwnerSide[level][i].rankComm;
 		ib = objman->bodyIDToIdx[markerCommOwnerSide[level][i].bodyID];
 		markerID = markerCommOwnerSide[level][i].markerID;
 
 		// Insert into buffer
-		sendBuffer[toRank].push_back(objman->iBody[ib].markers[markerID].ds);
+		plan.sendBuffer[plan.ownerSide.slot[i]] = objman->iBody[ib].markers[markerID].ds;
 	}
 
-	// Loop through and post send if there is data
-	std::vector<MPI_Request> sendRequests;
-	for (int toRank = 0; toRank < num_ranks; toRank++) {
-		if (sendBuffer[toRank].size() > 0) {
-			sendRequests.push_back(MPI_REQUEST_NULL);
-			MPI_Isend(&sendBuffer[toRank].front(), static_cast<int>(sendBuffer[toRank].size()),
-				MPI_DOUBLE, toRank, my_rank, world_comm, &sendRequests.back());
-		}
-	}
+	// Exchange the messages
+	mpi_startIBMComm(level, plan.ownerSide, plan.markerSide, 1);
+	mpi_finishIBMComm(level);
 
-	// Set up receive buffer sizes
-	std::vector<int> bufferSize(num_ranks, 0);
+	// Now unpack into ds values
+	int markerIdx;
+	for (size_t i = 0; i < markerCommMarkerSide[level].size(); i++) {
 
-	// Size the receive buffer
-	for (int i = 0; i < markerCommMarkerSide[level].size(); i++)
-		bufferSize[markerCommMarkerSide[level][i].rankComm]++;
+		// Get ID info
+		ib = objman->bodyIDToIdx[markerCommMarkerSide[level][i].bodyID];
+		markerIdx = markerCommMarkerSide[level][i].markerIdx;
 
-	// Declare receive buffer
-	std::vector<std::vector<double>> recvBuffer(num_ranks, std::vector<double>(0));
+		// Put into ds
+		objman->iBody[ib].markers[markerIdx].ds = plan.recvBuffer[plan.markerSide.slot[i]];
+	}
+}
 
-	// Loop through and receive if there is data
-	for (int fromRank = 0; fromRank < num_ranks; fromRank++) {
 
-		// Only do if there is information to receive
-		if (bufferSize[fromRank] > 0) {
-			recvBuffer[fromRank].resize(bufferSize[fromRank]);
-			MPI_Recv(&recvBuffer[fromRank].front(), static_cast<int>(recvBuffer[fromRank].size()),
-				MPI_DOUBLE, fromRank, fromRank, world_comm, MPI_STATUS_IGNORE);
-		}
+// *****************************************************************************
+///	\brief	Group the entries of an IBM comm class into one block per rank
+///
+///			Entries keep their relative order within the block of their rank
+///			so that packing and unpacking can both walk the comm class in 
+///			order using the slot of each entry.
+///
+///	\param	layout			layout to build
+///	\param	ranks			rank each entry is exchanged with
+///	\param	sizes			number of units each entry occupies
+void MpiManager::mpi_buildIBMCommLayout(IBCommLayoutStruct &layout,
+	const std::vector<int> &ranks, const std::vector<int> &sizes) {
+
+	// Get the distinct ranks
+	layout.ranks = ranks;
+	std::sort(layout.ranks.begin(), layout.ranks.end());
+	layout.ranks.erase(std::unique(layout.ranks.begin(), layout.ranks.end()), layout.ranks.end());
+
+	// Size the block of each rank
+	std::vector<int> block(ranks.size());
+	layout.offset.assign(layout.ranks.size() + 1, 0);
+	for (size_t i = 0; i < ranks.size(); i++) {
+		block[i] = static_cast<int>(std::lower_bound(layout.ranks.begin(), layout.ranks.end(), ranks[i]) - layout.ranks.begin());
+		layout.offset[block[i] + 1] += sizes[i];
+	}
+	std::partial_sum(layout.offset.begin(), layout.offset.end(), layout.offset.begin());
+
+	// Place each entry after the previous entries of its block
+	std::vector<int> next(layout.offset.begin(), layout.offset.end() - 1);
+	layout.slot.resize(ranks.size());
+	for (size_t i = 0; i < ranks.size(); i++) {
+		layout.slot[i] = next[block[i]];
+		next[block[i]] += sizes[i];
 	}
+}
 
-	// Create idx vector
-	std::vector<int> idx(num_ranks, 0);
 
-	// Now unpack into epsilon values
-	int fromRank, markerIdx;
-	for (int i = 0; i < markerCommMarkerSide[level].size(); i++) {
+// *****************************************************************************
+///	\brief	Post the packed IBM messages of a level
+///
+///			Receives are posted before the sends. The send buffer of the 
+///			level must already be packed using the send layout.
+///
+///	\param	level			current grid level
+///	\param	sendLayout		layout of the outgoing buffer
+///	\param	recvLayout		layout of the incoming buffer
+///	\param	width			number of values per unit of the layouts
+void MpiManager::mpi_startIBMComm(int level, const IBCommLayoutStruct &sendLayout,
+	const IBCommLayoutStruct &recvLayout, int width) {
 
-		// Get ID info
-		fromRank = markerCommMarkerSide[level][i].rankComm;
-		ib = objman->bodyIDToIdx[markerCommMarkerSide[level][i].bodyID];
-		markerIdx = markerCommMarkerSide[level][i].markerIdx;
+	// Size the receive buffer and requests
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	plan.recvBuffer.resize(recvLayout.offset.back() * width);
+	plan.requests.resize(sendLayout.ranks.size() + recvLayout.ranks.size());
 
-		// Put into epsilon
-		objman->iBody[ib].markers[markerIdx].ds = recvBuffer[fromRank][idx[fromRank]];
-		idx[fromRank]++;
+	// Post the receives
+	int r = 0;
+	for (size_t n = 0; n < recvLayout.ranks.size(); n++) {
+		MPI_Irecv(plan.recvBuffer.data() + recvLayout.offset[n] * width, (recvLayout.offset[n + 1] - recvLayout.offset[n]) * width,
+			MPI_DOUBLE, recvLayout.ranks[n], recvLayout.ranks[n], world_comm, &plan.requests[r++]);
+	}
+
+	// Post the sends
+	for (size_t n = 0; n < sendLayout.ranks.size(); n++) {
+		MPI_Isend(plan.sendBuffer.data() + sendLayout.offset[n] * width, (sendLayout.offset[n + 1] - sendLayout.offset[n]) * width,
+			MPI_DOUBLE, sendLayout.ranks[n], my_rank, world_comm, &plan.requests[r++]);
 	}
+}
+
+
+// *****************************************************************************
+///	\brief	Wait for the packed IBM messages of a level
+///
+///	\param	level			current grid level
+void MpiManager::mpi_finishIBMComm(int level) {
 
-	// If sending any messages then wait for request status
-	MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests.front(), MPI_STATUS_IGNORE);
+	// Wait for the receives and sends to complete
+	IBCommPlanStruct &plan = ibm_comm_plan[level];
+	MPI_Waitall(static_cast<int>(plan.requests.size()), plan.requests.data(), MPI_STATUSES_IGNORE);
+	plan.requests.clear();
 }
 
 
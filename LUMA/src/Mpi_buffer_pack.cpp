@@ -20,6 +20,7 @@
 * limitations under the License.*
 */
 
+
 #include "../inc/stdafx.h"
 #include "../inc/GridObj.h"
 
@@ -28,783 +29,61 @@
 /// \brief	Method to pack the communication buffer.
 ///
 ///			Communication buffer is packed with distribution values from the 
-///			supplied grid. Amount of information is dictated by the direction 
-///			of the communication being prepared.
+///			supplied grid. The sites packed are those requested by the 
+///			neighbour during the buffer size computation. Levels sending in 
+///			single precision send the deviation of each population from its
+///			lattice weight, which keeps more of the float's precision for the 
+///			part of the population that changes.
 ///
-/// \param	dir	communication direction.
+/// \param	nbr	index of the neighbour rank in the neighbour list.
 /// \param	g	grid from which information is being sent during the communication.
-void MpiManager::mpi_buffer_pack(int dir, GridObj* const g) {
+/// \param	offset	number of buffer words ahead of those of this grid.
+void MpiManager::mpi_buffer_pack(int nbr, GridObj* const g, size_t offset) {
 	
 	/* Imagine every grid overlap has an inner region with complete information post-stream
 	 * and an outer region with incomplete information post-stream.
 	 * In the case of the lower level grids the layers will increase in thickness by a 
 	 * factor of 2 with each refinement.
 	 * At every exchange, the inner layers need copying from one grid to the outer layer 
-	 * of its neighbour on the opposite side of the grid.
-	 * To start the process we copy the inner values to the f_buffer_send (intermediate buffer).
-	 * This buffer will also be used to receive the new values using MPI_Sendrecv_replace(). */
-	int idx, i, j , k, v;
-	// Local grid sizes for read/writing arrays
-	int N_lim = static_cast<int>(g->N_lim), M_lim = static_cast<int>(g->M_lim)
-#if (L_DIMS == 3)
-		, K_lim = static_cast<int>(g->K_lim);
-#else
-		, K_lim = 1;
-#endif
+	 * of its neighbour.
+	 * To start the process we copy the inner values to the f_buffer_send (intermediate buffer). */
 
 #ifdef L_MPI_VERBOSE
-	*logout << "Packing direction " << dir << std::endl;
+	*logout << "Packing neighbour " << nbr << std::endl;
 #endif
 
-	/* Copy outgoing information from inner layers to f_buffer_send using 
-	 * same idenifying logic as the buffer_size routine. */
-	idx = 0;
-
-
-	// Switch based on direction
-	switch (dir)
+	// Find the site list for this grid
+	for (size_t b = 0; b < buffer_send_info.size(); b++)
 	{
+		if (buffer_send_info[b].level != g->level || buffer_send_info[b].region != g->region_number) continue;
 
-	case 0:
-		// Right
-		
-		// Examine possible inner and outer buffer locations
-		for (range_i_right) {
-			for (j = 0; j < M_lim; j++) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMax) && 
-							(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin))
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 1:
-		// Left
-		
-		for (range_i_left) {
-			for (j = 0; j < M_lim; j++) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMin) && 
-							(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin))
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 2:
-		// Right-Up		
-
-		for (range_i_right) {
-			for (range_j_up) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMax) && 
-							GridUtils::isOnSenderLayer(g->YPos[j],eYMax)
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 3:
-		// Left-Down		
-
-		for (range_i_left) {
-			for (range_j_down) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMin) && 
-							GridUtils::isOnSenderLayer(g->YPos[j],eYMin)
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 4:
-		// Up		
-
-		for (i = 0; i < N_lim; i++) {
-			for (range_j_up) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) &&
-							GridUtils::isOnSenderLayer(g->YPos[j],eYMax)
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
+		// Copy outgoing information from inner layers to f_buffer_send
+		const std::vector<int>& sites = buffer_send_info[b].sites[nbr];
+		if (halo_single_precision[g->level])
+		{
+			// Floats are copied in as bytes as the buffer holds doubles
+			char *buf = reinterpret_cast<char *>(f_buffer_send[nbr].data() + offset);
+			float fsite[L_NUM_VELS];
+			for (size_t s = 0; s < sites.size(); s++) {
+				for (int v = 0; v < L_NUM_VELS; v++) {
+					fsite[v] = static_cast<float>(g->f[sites[s] * L_NUM_VELS + v] - w[v]);
 				}
+				memcpy(buf + s * sizeof(fsite), fsite, sizeof(fsite));
 			}
 		}
-		break;
-
-
-	case 5:
-		// Down		
-
-		for (i = 0; i < N_lim; i++) {
-			for (range_j_down) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) &&
-							GridUtils::isOnSenderLayer(g->YPos[j],eYMin)
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
+		else
+		{
+			double *buf = f_buffer_send[nbr].data() + offset;
+			for (size_t s = 0; s < sites.size(); s++) {
+				for (int v = 0; v < L_NUM_VELS; v++) {
+					buf[s * L_NUM_VELS + v] = g->f[sites[s] * L_NUM_VELS + v];
 				}
 			}
 		}
-		break;
-
-	case 6:
-		// Left-Up		
-
-		for (range_i_left) {
-			for (range_j_up) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMin) && 
-							GridUtils::isOnSenderLayer(g->YPos[j],eYMax)
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 7:
-		// Right-Down		
-
-		for (range_i_right) {
-			for (range_j_down) {
-				for (k = 0; k < K_lim; k++) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMax) && 
-							GridUtils::isOnSenderLayer(g->YPos[j],eYMin)
-#if (L_DIMS == 3)
-							&&
-							(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-
-	///////////////////////
-	// 3D-specific cases //
-	///////////////////////
-
-	case 8:
-		// Back		
-
-		for (i = 0; i < N_lim; i++) {
-			for (j = 0; j < M_lim; j++) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 9:
-		// Front		
-
-		for (i = 0; i < N_lim; i++) {
-			for (j = 0; j < M_lim; j++) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 10:
-		// Right-Back		
-
-		for (range_i_right) {
-			for (j = 0; j < M_lim; j++) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 11:
-		// Left-Front		
-
-		for (range_i_left) {
-			for (j = 0; j < M_lim; j++) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 12:
-		// Right-Up-Back		
-
-		for (range_i_right) {
-			for (range_j_up) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 13:
-		// Left-Down-Front		
-
-		for (range_i_left) {
-			for (range_j_down) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 14:
-		// Up-Back		
-
-		for (i = 0; i < N_lim; i++) {
-			for (range_j_up) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 15:
-		// Down-Front		
-
-		for (i = 0; i < N_lim; i++) {
-			for (range_j_down) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 16:
-		// Left-Up-Back		
-
-		for (range_i_left) {
-			for (range_j_up) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 17:
-		// Right-Down-Front		
-
-		for (range_i_right) {
-			for (range_j_down) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 18:
-		// Left-Back		
-
-		for (range_i_left) {
-			for (j = 0; j < M_lim; j++) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 19:
-		// Right-Front		
-
-		for (range_i_right) {
-			for (j = 0; j < M_lim; j++) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 20:
-		// Left-Down-Back		
-
-		for (range_i_left) {
-			for (range_j_down) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 21:
-		// Right-Up-Front		
-
-		for (range_i_right) {
-			for (range_j_up) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 22:
-		// Down-Back		
-
-		for (i = 0; i < N_lim; i++) {
-			for (range_j_down) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 23:
-		// Up-Front		
-
-		for (i = 0; i < N_lim; i++) {
-			for (range_j_up) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 24:
-		// Right-Down-Back		
-
-		for (range_i_right) {
-			for (range_j_down) {
-				for (range_k_back) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	case 25:
-		// Left-Up-Front		
-
-		for (range_i_left) {
-			for (range_j_up) {
-				for (range_k_front) {
-
-					// Check conditions for sender
-					if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-					{
-						if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-								(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-								(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-						) {
-							// Must be a site to send
-							for (v = 0; v < L_NUM_VELS; v++) {
-								f_buffer_send[dir][idx] = g->f(i,j,k,v,M_lim,K_lim,L_NUM_VELS);
-								idx++;
-							}
-						}
-					}
-
-				}
-			}
-		}
-		break;
-
-	default:
-		std::cout << "Unidentified direction: " << dir << std::endl;
-		break;
 	}
 
 #ifdef L_MPI_VERBOSE
-	*logout << "Packing direction " << dir << " complete." << std::endl;
+	*logout << "Packing neighbour " << nbr << " complete." << std::endl;
 #endif
 
-}
\ No newline at end of file
+}
@@ -20,21 +20,27 @@
 * limitations under the License.*
 */
 
+
 #include "../inc/stdafx.h"
 #include "../inc/GridObj.h"
 
 
 // ****************************************************************************
-/// \brief	Method to pre-compute the size of the receiver layer buffer.
+/// \brief	Method to pre-compute the receiver layer sites.
 ///
 ///			A halo consists of a receiver (outer) and sender (inner) layer. 
-///			This method computes the size of the receiver layers in each 
-///			communication direction (MPI directions).
+///			This method finds the receiver layer sites of the grid and the 
+///			neighbour rank which owns each one. The global index of each 
+///			site is added to the request list for that neighbour so that the
+///			owner can build the matching send list. With face exchanges the 
+///			site is requested from the face neighbour which forwards it. Only 
+///			the layers of the halo read before the next exchange are included.
 ///
-/// \param	g	grid being inspected.
-void MpiManager::mpi_buffer_size_recv(GridObj* const g) {
+/// \param	g			grid being inspected.
+/// \param	requests	site requests for each neighbour, appended to.
+void MpiManager::mpi_buffer_size_recv(GridObj* const g, std::vector< std::vector<int> >& requests) {
 
-	int count, i, j, k, dir;	// Local counters
+	int i, j, k;	// Local counters
 	// Local grid sizes
 	int N_lim = static_cast<int>(g->N_lim), M_lim = static_cast<int>(g->M_lim)
 #if (L_DIMS == 3)
@@ -43,731 +49,88 @@ void MpiManager::mpi_buffer_size_recv(GridObj* const g) {
 		, K_lim = 1;
 #endif
 
-	/* Loop over the allowable directions:
-	* 0		=	Right
-	* 1		=	Left
-	* 2		=	Right-Up
-	* 3		=	Left-Down
-	* 4		=	Up
-	* 5		=	Down
-	* 6		=	Left-Up
-	* 7		=	Right-Down
-	* -------- 3D --------
-	* 8		=	Back
-	* 9		=	Front
-	* 10	=	Right-Back
-	* 11	=	Left-Front
-	* 12	=	Right-Up-Back
-	* 13	=	Left-Down-Front
-	* 14	=	Up-Back
-	* 15	=	Down-Front
-	* 16	=	Left-Up-Back
-	* 17	=	Right-Down-Front
-	* 18	=	Left-Back
-	* 19	=	Right-Front
-	* 20	=	Left-Down-Back
-	* 21	=	Right-Up-Front
-	* 22	=	Down-Back
-	* 23	=	Up-Front
-	* 24	=	Right-Down-Back
-	* 25	=	Left-Up-Front
-	*/
-	for (dir = 0; dir < L_MPI_DIRS; dir++)  {
-
-		// Reset the site counter
-		count = 0;
-
-		// Switch based on direction
-		switch (dir)
+	// Site lists for this grid
+	BufferSiteStruct& info = buffer_recv_info.back();
+
+	/* Layer of the halo in which a position lies (counted outwards from the
+	 * core in cells of this grid) or zero if it is not in the halo. */
+	const double *recvEdges[3] = { recv_layer_pos.X, recv_layer_pos.Y, recv_layer_pos.Z };
+	auto haloLayer = [&](double x, int d) -> int
+	{
+		int layer = 0;
+		if (GridUtils::isOnRecvLayer(x, static_cast<eCartMinMax>(2 * d)))
+			layer = static_cast<int>((recvEdges[d][eLeftMax] - x) / g->dh) + 1;
+		if (GridUtils::isOnRecvLayer(x, static_cast<eCartMinMax>(2 * d + 1)))
 		{
+			int right = static_cast<int>((x - recvEdges[d][eRightMin]) / g->dh) + 1;
+			if (layer == 0 || right < layer) layer = right;
+		}
+		return layer;
+	};
 
-		case 0:
-			// Right (but receiving from rank on left)
-		
-			// Examine possible inner and outer buffer locations
-			for (range_i_left) {
-				for (j = 0; j < M_lim; j++) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax))
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 1:
-			// Left (but receiving from rank on right)
-		
-
-			for (range_i_right) {
-				for (j = 0; j < M_lim; j++) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax))
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-					
-					}
-				}
-			}
-			break;
-
-		case 2:
-			// Right-Up
-		
-
-			for (range_i_left) {
-				for (range_j_down) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && 
-								GridUtils::isOnRecvLayer(g->YPos[j],eYMin)
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 3:
-			// Left-Down
-		
-
-			for (range_i_right) {
-				for (range_j_up) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && 
-								GridUtils::isOnRecvLayer(g->YPos[j],eYMax)
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 4:
-			// Up
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_down) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) &&
-								GridUtils::isOnRecvLayer(g->YPos[j],eYMin)
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-
-		case 5:
-			// Down
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_up) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) &&
-								GridUtils::isOnRecvLayer(g->YPos[j],eYMax)
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 6:
-			// Left-Up
-		
-
-			for (range_i_right) {
-				for (range_j_down) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && 
-								GridUtils::isOnRecvLayer(g->YPos[j],eYMin)
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 7:
-			// Right-Down
-		
-
-			for (range_i_left) {
-				for (range_j_up) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if (  GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && 
-								GridUtils::isOnRecvLayer(g->YPos[j],eYMax)
-	#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMin) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-	#endif
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-
-		///////////////////////
-		// 3D-specific cases //
-		///////////////////////
-
-		case 8:
-			// Back
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 9:
-			// Front
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 10:
-			// Right-Back
-		
-
-			for (range_i_left) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 11:
-			// Left-Front
-		
-
-			for (range_i_right) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 12:
-			// Right-Up-Back
-		
-
-			for (range_i_left) {
-				for (range_j_down) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 13:
-			// Left-Down-Front
-		
-
-			for (range_i_right) {
-				for (range_j_up) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 14:
-			// Up-Back
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_down) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 15:
-			// Down-Front
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_up) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 16:
-			// Left-Up-Back
-		
-
-			for (range_i_right) {
-				for (range_j_down) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 17:
-			// Right-Down-Front
-		
-
-			for (range_i_left) {
-				for (range_j_up) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 18:
-			// Left-Back
-		
-
-			for (range_i_right) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 19:
-			// Right-Front
-		
-
-			for (range_i_left) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 20:
-			// Left-Down-Back
-		
-
-			for (range_i_right) {
-				for (range_j_up) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 21:
-			// Right-Up-Front
-		
-
-			for (range_i_left) {
-				for (range_j_down) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 22:
-			// Down-Back
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_up) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 23:
-			// Up-Front
-		
-
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_down) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMax) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 24:
-			// Right-Down-Back
-		
-
-			for (range_i_left) {
-				for (range_j_up) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 25:
-			// Left-Up-Front
-		
+	for (i = 0; i < N_lim; i++) {
+		for (j = 0; j < M_lim; j++) {
+			for (k = 0; k < K_lim; k++) {
 
-			for (range_i_right) {
-				for (range_j_down) {
-					for (range_k_back) {
+				// Refined sites are not passed
+				if (g->LatTyp(i, j, k, M_lim, K_lim) == eRefined) continue;
 
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Refined sites are not passed
-						{
-							if ( (GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnRecvLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnRecvLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be suitable receiver site
-								count++;
-							}
-						}
+				// Only receiver sites are filled by the exchange
+				if (!GridUtils::isOnRecvLayer(g->XPos[i], g->YPos[j], g->ZPos[k])) continue;
 
-					}
+				// Skip layers beyond those which are read before the next exchange
+				if (haloLayer(g->XPos[i], eXDirection) > halo_exchange_depth[g->level] || 
+					haloLayer(g->YPos[j], eYDirection) > halo_exchange_depth[g->level]
+#if (L_DIMS == 3)
+					|| haloLayer(g->ZPos[k], eZDirection) > halo_exchange_depth[g->level]
+#endif
+					) continue;
+
+				// Find the neighbour which owns this site
+				std::vector<double> position = { g->XPos[i], g->YPos[j], g->ZPos[k] };
+#ifdef L_MPI_FACE_EXCHANGE
+				/* The site arrives in the stage of the last direction in which it 
+				 * lies in the halo. It is sent by the face neighbour in that 
+				 * direction which will have received it from its own face 
+				 * neighbours in the earlier stages. */
+				int stage = 0;
+				for (int d = 0; d < L_DIMS; d++)
+				{
+					if (GridUtils::isOnRecvLayer(position[d], static_cast<eCartMinMax>(2 * d)) ||
+						GridUtils::isOnRecvLayer(position[d], static_cast<eCartMinMax>(2 * d + 1))) stage = d;
+				}
+				for (int d = 0; d < stage; d++)
+				{
+					position[d] = 0.5 * (rank_core_edge[2 * d][my_rank] + rank_core_edge[2 * d + 1][my_rank]);
 				}
+#endif
+				int owner = GridUtils::getRankfromPosition(position);
+				auto it = std::find(neighbour_rank.begin(), neighbour_rank.end(), owner);
+				if (owner == my_rank || it == neighbour_rank.end()
+#ifdef L_MPI_FACE_EXCHANGE
+					|| neighbour_stage[it - neighbour_rank.begin()] != stage
+#endif
+					)
+				{
+					L_ERROR("Receiver site at (" + std::to_string(g->XPos[i]) + "," + std::to_string(g->YPos[j]) + "," + 
+						std::to_string(g->ZPos[k]) + ") on L" + std::to_string(g->level) + "R" + std::to_string(g->region_number) +
+						" is owned by rank " + std::to_string(owner) + " which is not a neighbour. Exiting.", GridUtils::logfile);
+				}
+				size_t n = it - neighbour_rank.begin();
+
+				// Store local index and request the site from the owner
+				info.sites[n].push_back(k + j * K_lim + i * K_lim * M_lim);
+				requests[n].push_back(g->level);
+				requests[n].push_back(g->region_number);
+				requests[n].push_back(static_cast<int>(std::floor(g->XPos[i] / g->dh)));
+				requests[n].push_back(static_cast<int>(std::floor(g->YPos[j] / g->dh)));
+#if (L_DIMS == 3)
+				requests[n].push_back(static_cast<int>(std::floor(g->ZPos[k] / g->dh)));
+#else
+				requests[n].push_back(0);
+#endif
 			}
-			break;
-
-		default:
-			std::cout << "Unidentified direction: " << dir << std::endl;
-			break;
 		}
-
-		// Store the count of sites in the MpiManager buffer_info structure
-		buffer_recv_info.back().size[dir] = count;
 	}
 
-}
\ No newline at end of file
+}
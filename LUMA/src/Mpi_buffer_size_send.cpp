@@ -20,21 +20,23 @@
 * limitations under the License.*
 */
 
+
 #include "../inc/stdafx.h"
 #include "../inc/GridObj.h"
 
 
 // ****************************************************************************
-/// \brief	Method to pre-compute the size of the sender layer buffer.
+/// \brief	Method to pre-compute the sender layer sites.
 ///
 ///			A halo consists of a receiver (outer) and sender (inner) layer. 
-///			This method computes the size of the sender layers in each 
-///			communication direction (MPI directions).
+///			This method converts the sites requested by each neighbour for 
+///			the supplied grid into local indices, kept in the order in which
+///			they were requested so that they match the receiver's buffer.
 ///
-/// \param	g	grid being inspected.
-void MpiManager::mpi_buffer_size_send(GridObj* const g) {
-	
-	int count, i, j, k, dir;	// Local counters
+/// \param	g			grid being inspected.
+/// \param	requests	site requests received from each neighbour.
+void MpiManager::mpi_buffer_size_send(GridObj* const g, std::vector< std::vector<int> >& requests) {
+
 	// Local grid sizes
 	int N_lim = static_cast<int>(g->N_lim), M_lim = static_cast<int>(g->M_lim)
 #if (L_DIMS == 3)
@@ -42,684 +44,69 @@ void MpiManager::mpi_buffer_size_send(GridObj* const g) {
 #else
 		, K_lim = 1;
 #endif
-
-	/* Loop over the allowable directions:
-	* 0		=	Right
-	* 1		=	Left
-	* 2		=	Right-Up
-	* 3		=	Left-Down
-	* 4		=	Up
-	* 5		=	Down
-	* 6		=	Left-Up
-	* 7		=	Right-Down
-	* -------- 3D --------
-	* 8		=	Back
-	* 9		=	Front
-	* 10	=	Right-Back
-	* 11	=	Left-Front
-	* 12	=	Right-Up-Back
-	* 13	=	Left-Down-Front
-	* 14	=	Up-Back
-	* 15	=	Down-Front
-	* 16	=	Left-Up-Back
-	* 17	=	Right-Down-Front
-	* 18	=	Left-Back
-	* 19	=	Right-Front
-	* 20	=	Left-Down-Back
-	* 21	=	Right-Up-Front
-	* 22	=	Down-Back
-	* 23	=	Up-Front
-	* 24	=	Right-Down-Back
-	* 25	=	Left-Up-Front
-	*/
-	for (dir = 0; dir < L_MPI_DIRS; dir++)  {
-
-		// Reset the site counter
-		count = 0;
-
-		// Switch based on direction
-		switch (dir)
-		{
-
-		case 0:
-			// Right
-
-			// Examine possible inner and outer buffer locations
-			for (range_i_right) {
-				for (j = 0; j < M_lim; j++) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMax) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin))
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-							) {
-
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 1:
-			// Left
-			for (range_i_left) {
-				for (j = 0; j < M_lim; j++) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMin) && 
-								(!GridUtils::isOnRecvLayer(g->YPos[j],eYMax) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMin))
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 2:
-			// Right-Up
-			for (range_i_right) {
-				for (range_j_up) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMax) && 
-								GridUtils::isOnSenderLayer(g->YPos[j],eYMax)
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 3:
-			// Left-Down
-			for (range_i_left) {
-				for (range_j_down) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMin) && 
-								GridUtils::isOnSenderLayer(g->YPos[j],eYMin)
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 4:
-			// Up
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_up) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) &&
-								GridUtils::isOnSenderLayer(g->YPos[j],eYMax)
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-
-		case 5:
-			// Down
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_down) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) &&
-								GridUtils::isOnSenderLayer(g->YPos[j],eYMin)
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 6:
-			// Left-Up
-			for (range_i_left) {
-				for (range_j_up) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMin) && 
-								GridUtils::isOnSenderLayer(g->YPos[j],eYMax)
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
-#endif
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 7:
-			// Right-Down
-			for (range_i_right) {
-				for (range_j_down) {
-					for (k = 0; k < K_lim; k++) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if (  GridUtils::isOnSenderLayer(g->XPos[i],eXMax) && 
-								GridUtils::isOnSenderLayer(g->YPos[j],eYMin)
-#if (L_DIMS == 3)
-								&&
-								(!GridUtils::isOnRecvLayer(g->ZPos[k],eZMax) && !GridUtils::isOnRecvLayer(g->ZPos[k],eZMin))
+	int lims[3] = { N_lim, M_lim, K_lim };
+	std::vector<double> *pos[3] = { &g->XPos, &g->YPos, &g->ZPos };
+
+	/* Map global indices to local indices in each direction using the core
+	 * sites. Positions may wrap periodically so are not always increasing. 
+	 * Face exchanges also forward halo sites so these are added where they 
+	 * do not clash with a core site. */
+	std::vector< std::vector<int> > localIdx(3, std::vector<int>(1, 0));
+#ifdef L_MPI_FACE_EXCHANGE
+	const int numPasses = 2;
+#else
+	const int numPasses = 1;
 #endif
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-
-		///////////////////////
-		// 3D-specific cases //
-		///////////////////////
-
-		case 8:
-			// Back
-			for (i = 0; i < N_lim; i++) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 9:
-			// Front
-			for (i = 0; i < N_lim; i++) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 10:
-			// Right-Back
-			for (range_i_right) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 11:
-			// Left-Front
-			for (range_i_left) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 12:
-			// Right-Up-Back
-			for (range_i_right) {
-				for (range_j_up) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 13:
-			// Left-Down-Front
-			for (range_i_left) {
-				for (range_j_down) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 14:
-			// Up-Back
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_up) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 15:
-			// Down-Front
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_down) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 16:
-			// Left-Up-Back
-			for (range_i_left) {
-				for (range_j_up) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 17:
-			// Right-Down-Front
-			for (range_i_right) {
-				for (range_j_down) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 18:
-			// Left-Back
-			for (range_i_left) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 19:
-			// Right-Front
-			for (range_i_right) {
-				for (j = 0; j < M_lim; j++) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-									(!GridUtils::isOnRecvLayer(g->YPos[j],eYMin) && !GridUtils::isOnRecvLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 20:
-			// Left-Down-Back
-			for (range_i_left) {
-				for (range_j_down) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 21:
-			// Right-Up-Front
-			for (range_i_right) {
-				for (range_j_up) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 22:
-			// Down-Back
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_down) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 23:
-			// Up-Front
-			for (i = 0; i < N_lim; i++) {
-				for (range_j_up) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (!GridUtils::isOnRecvLayer(g->XPos[i],eXMin) && !GridUtils::isOnRecvLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
-			}
-			break;
-
-		case 24:
-			// Right-Down-Back
-			for (range_i_right) {
-				for (range_j_down) {
-					for (range_k_back) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMax)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMin)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMax))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
-
-					}
-				}
+	for (int d = 0; d < L_DIMS; d++)
+	{
+		localIdx[d].assign(static_cast<size_t>(std::floor(*std::max_element(pos[d]->begin(), pos[d]->end()) / g->dh)) + 1, -1);
+		for (int pass = 0; pass < numPasses; pass++)
+		{
+			for (int i = 0; i < lims[d]; i++)
+			{
+				double x = (*pos[d])[i];
+				bool bHalo = GridUtils::isOnRecvLayer(x, static_cast<eCartMinMax>(2 * d)) ||
+					GridUtils::isOnRecvLayer(x, static_cast<eCartMinMax>(2 * d + 1));
+				int gIdx = static_cast<int>(std::floor(x / g->dh));
+				if (bHalo == (pass == 1) && localIdx[d][gIdx] == -1) localIdx[d][gIdx] = i;
 			}
-			break;
-
-		case 25:
-			// Left-Up-Front
-			for (range_i_left) {
-				for (range_j_up) {
-					for (range_k_front) {
-
-						// Check conditions for sender
-						if (g->LatTyp(i,j,k,M_lim,K_lim) != eRefined)	// Do not pass refined sites as zero anyway
-						{
-							if ( (GridUtils::isOnSenderLayer(g->XPos[i],eXMin)) && 
-									(GridUtils::isOnSenderLayer(g->YPos[j],eYMax)) &&
-									(GridUtils::isOnSenderLayer(g->ZPos[k],eZMin))
-							) {
-								// Must be a site to pass in MPI so increment counter
-								count++;
-							}
-						}
+		}
+	}
 
-					}
-				}
-			}
-			break;
+	// Site lists for this grid
+	BufferSiteStruct *info = nullptr;
+	for (size_t b = 0; b < buffer_send_info.size(); b++)
+	{
+		if (buffer_send_info[b].level == g->level && buffer_send_info[b].region == g->region_number)
+			info = &buffer_send_info[b];
+	}
 
-		default:
-			std::cout << "Unidentified direction: " << dir << std::endl;
-			break;
+	// Loop over each neighbour's requests and pick out those for this grid
+	for (size_t n = 0; n < requests.size(); n++)
+	{
+		for (size_t r = 0; r < requests[n].size(); r += 5)
+		{
+			if (requests[n][r] != g->level || requests[n][r + 1] != g->region_number) continue;
+
+			// Check the site is one of ours
+			int ijk[3];
+			bool valid = true;
+			for (int d = 0; d < 3; d++)
+			{
+				int gIdx = requests[n][r + 2 + d];
+				ijk[d] = (gIdx >= 0 && gIdx < static_cast<int>(localIdx[d].size())) ? localIdx[d][gIdx] : -1;
+				if (ijk[d] == -1) valid = false;
+			}
+			if (!valid)
+			{
+				L_ERROR("Rank " + std::to_string(neighbour_rank[n]) + " requested site (" + 
+					std::to_string(requests[n][r + 2]) + "," + std::to_string(requests[n][r + 3]) + "," + std::to_string(requests[n][r + 4]) + 
+					") on L" + std::to_string(g->level) + "R" + std::to_string(g->region_number) + 
+					" which is not on this rank. Exiting.", GridUtils::logfile);
+			}
+
+			info->sites[n].push_back(ijk[2] + ijk[1] * K_lim + ijk[0] * K_lim * M_lim);
 		}
-			
-		// Store the count of sites in the MpiManager buffer_info structure
-		buffer_send_info.back().size[dir] = count;				
-
 	}
 
-}
\ No newline at end of file
+}
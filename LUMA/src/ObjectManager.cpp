@@ -57,6 +57,7 @@ void ObjectManager::destroyInstance() {
 /// Default constructor
 ObjectManager::ObjectManager(void) {
 	_Grids = nullptr;
+	ibmPrecomputeRestored = false;
 };
 
 /// Default destructor
@@ -72,6 +73,9 @@ ObjectManager::ObjectManager(GridObj* g) : _Grids(g)
 	// Resize vector of flexible body flags
 	hasIBMBodies.resize(L_NUM_LEVELS+1 ,false);
 	hasFlexibleBodies.resize(L_NUM_LEVELS+1 ,false);
+	ibmSupportPack.resize(L_NUM_LEVELS+1);
+	ibmSubIterState.resize(L_NUM_LEVELS+1);
+	ibmPrecomputeRestored = false;
 
 	// Set sub-iteration loop values
 	timeav_subResidual = 0.0;
@@ -32,6 +32,10 @@
 ///	\param	doSubIterate		flag to switch sub-iterations on
 void ObjectManager::ibm_apply(GridObj *g, bool doSubIterate) {
 
+	// Save the start-of-step velocities of the sites about to be modified
+	if (hasFlexibleBodies[g->level])
+		ibm_saveSubIterSites(g, doSubIterate);
+
 	// Interpolate the velocity onto the markers
 	ibm_interpolate(g->level);
 
@@ -68,6 +72,9 @@ void ObjectManager::ibm_moveBodies(int level) {
 
 	// Pass delta values
 	mpim->mpi_forceCommGather(level);
+
+	// Record the marker layout before the markers move
+	std::vector<int> oldLayout = ibm_markerLayout(level);
 #endif
 
 	// Loop through flexible bodies and apply FEM
@@ -78,22 +85,38 @@ void ObjectManager::ibm_moveBodies(int level) {
 			iBody[ib].fBody->dynamicFEM();
 	}
 
-	// Update IBM markers
+	// Update IBM markers (a change in who holds them needs the comm classes rebuilt)
+	eSupportChange change = eSupportUnchanged;
 #ifdef L_BUILD_FOR_MPI
 	ibm_updateMarkers(level);
+	if (ibm_markerLayout(level) != oldLayout)
+		change = eSupportCrossed;
 #endif
 
 	// Loop through flexible bodies and update the support points for all valid markers existing on this rank
+	bool rebuilt = false;
+	std::vector<std::vector<bool>> moved(iBody.size());
 	for (size_t ib = 0; ib < iBody.size(); ib++) {
 
 		// Only do if on this grid level
-		if (iBody[ib]._Owner->level == level && iBody[ib].isFlexible)
-			ibm_findSupport(static_cast<int>(ib));
+		if (iBody[ib]._Owner->level == level && iBody[ib].isFlexible) {
+			eSupportChange bodyChange = ibm_findSupport(static_cast<int>(ib), &moved[ib]);
+			change = std::max(change, bodyChange);
+			if (bodyChange != eSupportUnchanged)
+				rebuilt = true;
+		}
 	}
 
-	// Update MPI comm vector
+	/* Rebuild the MPI comm classes if the owning rank of any marker or 
+	 * support site changed on any rank. If the off-rank sites only moved 
+	 * then just the entries of those markers are updated. */
 #ifdef L_BUILD_FOR_MPI
-	ibm_updateMPIComms(level);
+	int changeLocal = change, changeAny = eSupportUnchanged;
+	MPI_Allreduce(&changeLocal, &changeAny, 1, MPI_INT, MPI_MAX, mpim->lev_comm[level]);
+	if (changeAny == eSupportCrossed)
+		ibm_updateMPIComms(level);
+	else if (changeAny == eSupportMoved)
+		mpim->mpi_refreshSupportComms(level, moved);
 #endif
 
 	// Compute ds
@@ -101,6 +124,78 @@ void ObjectManager::ibm_moveBodies(int level) {
 
 	// Find epsilon for the body
 	ibm_findEpsilon(level);
+
+	// Pack the new supports
+	ibm_packSupport(level, rebuilt);
+}
+
+
+// *****************************************************************************
+///	\brief	Save the start-of-step velocities of the current support sites
+///
+///			Only sites which have not already been saved during this time 
+///			step are recorded, so the saved set grows to the union of all
+///			supports visited by the sub-iterations while each site keeps the
+///			velocity it had before any IBM operation of this step.
+///
+///	\param	g			pointer to current grid
+///	\param	newStep		flag to discard the sites saved in the previous time step
+void ObjectManager::ibm_saveSubIterSites(GridObj *g, bool newStep) {
+
+	// Get the state for this level
+	IBSubIterState &state = ibmSubIterState[g->level];
+	int nSites = g->N_lim * g->M_lim * g->K_lim;
+	if (static_cast<int>(state.savedAt.size()) != nSites) {
+		state.savedAt.assign(nSites, 0);
+		state.step = 0;
+	}
+
+	// Start a new set of sites
+	if (newStep) {
+		state.step++;
+		state.sites.clear();
+		state.u.clear();
+	}
+
+	// Save a site if it has not been saved yet this step
+	auto save = [&](int id) {
+		if (state.savedAt[id] != state.step) {
+			state.savedAt[id] = state.step;
+			state.sites.push_back(id);
+			for (int d = 0; d < L_DIMS; d++)
+				state.u.push_back(g->u[id * L_DIMS + d]);
+		}
+	};
+
+	// Each distinct support site on this grid
+	IBSupportPack &pack = ibmSupportPack[g->level];
+	for (size_t n = 0; n < pack.uniqueSite.size(); n++) {
+		if (iBody[pack.uniqueBody[n]]._Owner == g)
+			save(pack.uniqueSite[n]);
+	}
+}
+
+
+// *****************************************************************************
+///	\brief	Restore the saved support sites to the start of the time step
+///
+///			Velocities and forces only change at the support sites of the
+///			markers, so resetting the saved sites is equivalent to resetting
+///			the whole grid.
+///
+///	\param	g		pointer to current grid
+void ObjectManager::ibm_restoreSubIterSites(GridObj *g) {
+
+	// Get the state for this level
+	IBSubIterState &state = ibmSubIterState[g->level];
+
+	// Reset velocity and force at each saved site
+	for (size_t s = 0; s < state.sites.size(); s++) {
+		int id = state.sites[s];
+		for (int d = 0; d < L_DIMS; d++)
+			g->u[id * L_DIMS + d] = state.u[s * L_DIMS + d];
+		g->_LBM_resetForces(id);
+	}
 }
 
 
@@ -113,17 +208,12 @@ void ObjectManager::ibm_subIterate(GridObj *g) {
 	// While loop parameters
 	double res;
 	int it = 0;
-	int MAXIT = 10;
-	double TOL = 1e-4;
 
 	// Do the while loop for sub iteration
 	do {
 
-		// Reset velocities to start of time step
-		g->u = g->u_n;
-
-		// Reset forces
-		g->_LBM_resetForces();
+		// Reset velocities and forces at the support sites to start of time step
+		ibm_restoreSubIterSites(g);
 
 		// Apply IBM again
 		ibm_apply(g, false);
@@ -134,7 +224,13 @@ void ObjectManager::ibm_subIterate(GridObj *g) {
 		// Increment counter
 		it++;
 
-	} while (res > TOL && it < MAXIT);
+	} while (res > L_FSI_TOL && it < L_FSI_MAX_IT);
+
+	// Write out the sub-iterations of this time step
+#ifdef L_WRITE_SUBITERATIONS
+	*GridUtils::logfile << "Grid " << g->level << " time step " << g->t << ": " << it << 
+		" sub-iterations to reach a residual of " << res << std::endl;
+#endif
 
 	// Get time averaged sub-iteration values
 	timeav_subResidual *= (g->t % L_GRID_OUT_FREQ);
@@ -156,6 +252,9 @@ void ObjectManager::ibm_subIterate(GridObj *g) {
 			iBody[ib].fBody->Udot_n = iBody[ib].fBody->Udot;
 			iBody[ib].fBody->Udotdot_n = iBody[ib].fBody->Udotdot;
 
+			// Start the coupling afresh next time step
+			iBody[ib].fBody->resetCoupling();
+
 			// Get time averaged FEM values
 			iBody[ib].fBody->timeav_FEMIterations *= (g->t % L_GRID_OUT_FREQ);
 			iBody[ib].fBody->timeav_FEMIterations += iBody[ib].fBody->it;
@@ -225,13 +324,30 @@ void ObjectManager::ibm_initialise() {
 		ibm_updateMPIComms(lev);
 #endif
 
-	// Compute ds
-	for (int lev = 0; lev < (levToLoop+1); lev++)
-		ibm_computeDs(lev);
+	/* Reuse ds and epsilon read from the restart file if every rank found
+	 * them valid for its bodies, otherwise compute them from scratch. */
+	int restored = ibmPrecomputeRestored;
+	ibmPrecomputeRestored = false;
+#ifdef L_BUILD_FOR_MPI
+	MPI_Allreduce(MPI_IN_PLACE, &restored, 1, MPI_INT, MPI_LAND, MpiManager::getInstance()->world_comm);
+#endif
+	if (restored) {
+		L_INFO("Using IBM ds and epsilon values from restart file.", GridUtils::logfile);
+	}
+	else {
 
-	// Find epsilon for the body
+		// Compute ds
+		for (int lev = 0; lev < (levToLoop+1); lev++)
+			ibm_computeDs(lev);
+
+		// Find epsilon for the body
+		for (int lev = 0; lev < (levToLoop+1); lev++)
+			ibm_findEpsilon(lev);
+	}
+
+	// Pack the supports
 	for (int lev = 0; lev < (levToLoop+1); lev++)
-		ibm_findEpsilon(lev);
+		ibm_packSupport(lev);
 
 	// Write out epsilon
 #ifdef L_IBM_DEBUG
@@ -241,6 +357,40 @@ void ObjectManager::ibm_initialise() {
 }
 
 
+// *****************************************************************************
+///	\brief	Rebuild the IBM support after the domain is re-decomposed
+///
+///			Only the bodies flagged as changed have their support found 
+///			again. ds and epsilon do not depend on the decomposition so they 
+///			are kept. The comm classes and packed stencils are rebuilt on 
+///			every level as they cover all bodies on the level.
+///
+///	\param	changed		flag for each body ID set if its support must be rebuilt.
+void ObjectManager::ibm_reinitialise(const std::vector<int> &changed) {
+
+	// Find support points for the changed bodies
+	for (int ib = 0; ib < static_cast<int>(iBody.size()); ib++) {
+		if (changed[iBody[ib].id])
+			ibm_findSupport(ib);
+	}
+
+	// Get number of levels to loop through
+#ifdef L_BUILD_FOR_MPI
+	int levToLoop = MpiManager::getInstance()->rankGrids[MpiManager::getInstance()->my_rank];
+
+	// Build helper classes for MPI comms
+	for (int lev = 0; lev < (levToLoop+1); lev++)
+		ibm_updateMPIComms(lev);
+#else
+	int levToLoop = L_NUM_LEVELS+1;
+#endif
+
+	// Pack the supports
+	for (int lev = 0; lev < (levToLoop+1); lev++)
+		ibm_packSupport(lev);
+}
+
+
 // *****************************************************************************
 ///	\brief	Method to evaluate delta kernel at supplied location
 ///
@@ -258,9 +408,9 @@ double ObjectManager::ibm_deltaKernel(double radius, double dilation) {
 	if (mag_r > 1.5) {
 		value = 0.0;
 	} else if (mag_r > 0.5) {
-		value = (5.0 - (3.0 * mag_r) - sqrt(-3.0 * pow( 1.0 - mag_r, 2) + 1.0)) / 6.0;
+		value = (5.0 - (3.0 * mag_r) - sqrt(-3.0 * ((1.0 - mag_r) * (1.0 - mag_r)) + 1.0)) / 6.0;
 	} else {
-		value = (1.0 + sqrt(1.0 - 3.0 * pow(mag_r, 2) ) ) / 3.0;
+		value = (1.0 + sqrt(1.0 - 3.0 * (mag_r * mag_r))) / 3.0;
 	}
 
 	return value;
@@ -270,13 +420,17 @@ double ObjectManager::ibm_deltaKernel(double radius, double dilation) {
 // *****************************************************************************
 ///	\brief	Finds support points for iBody
 ///
+///			Markers whose enclosing voxel and support cage are unchanged since
+///			their support was last found keep their support sites and only 
+///			have their delta values updated. Markers whose rebuilt support is 
+///			owned by the same ranks as before are flagged in moved if any of 
+///			their sites are off-rank so that only those entries of the MPI 
+///			comm classes need updating.
+///
 ///	\param	ib			body index
-void ObjectManager::ibm_findSupport(int ib) {
-
-#ifdef L_BUILD_FOR_MPI
-	MpiManager *mpim = MpiManager::getInstance();
-	int estimated_rank_offset[3] = { 0, 0, 0 };
-#endif
+///	\param	moved		optional flags (one per marker) set for markers whose off-rank sites moved
+///	\return	extent of the change to the support sites of the markers
+eSupportChange ObjectManager::ibm_findSupport(int ib, std::vector<bool> *moved) {
 
 	// Get the rank
 	int rank = GridUtils::safeGetRank();
@@ -287,25 +441,26 @@ void ObjectManager::ibm_findSupport(int ib) {
 	std::vector<double> nearpos(3, 0);
 	std::vector<double> estimated_position(3, 0);
 
+	/* The support is a tensor product of the sites along each axis of the cage 
+	 * so the kernel is evaluated once per axis offset and the weight of each 
+	 * support site formed from the product of its axis weights. */
+	const int cage = 5;
+	double axisWeight[L_DIMS][2 * cage + 1];
+	bool axisInside[L_DIMS][2 * cage + 1];
+	double weights[L_DIMS];
+
 	// Loop through all valid markers (which exist on this rank)
+	eSupportChange change = eSupportUnchanged;
+	std::vector<int> oldRanks;
+	if (moved) moved->assign(iBody[ib].markers.size(), false);
 	for (auto m : iBody[ib].validMarkers) {
 
-		// First clear all the previous (now invalid) support points
-		iBody[ib].markers[m].supp_i.clear();
-		iBody[ib].markers[m].supp_j.clear();
-		iBody[ib].markers[m].supp_k.clear();
-		iBody[ib].markers[m].supp_x.clear();
-		iBody[ib].markers[m].supp_y.clear();
-		iBody[ib].markers[m].supp_z.clear();
-		iBody[ib].markers[m].deltaval.clear();
-		iBody[ib].markers[m].support_rank.clear();
-
 		// Get the marker position
 		x = iBody[ib].markers[m].position[eXDirection];
 		y = iBody[ib].markers[m].position[eYDirection];
 		z = iBody[ib].markers[m].position[eZDirection];
 
-		// Get ijk of enclosing voxel and insert into support
+		// Get ijk of enclosing voxel
 		std::vector<int> ijk;
 		GridUtils::getEnclosingVoxel(x, y, z, iBody[ib]._Owner, &ijk);
 
@@ -314,11 +469,6 @@ void ObjectManager::ibm_findSupport(int ib) {
 		jnear = ijk[eYDirection];
 		knear = ijk[eZDirection];
 
-		// Insert into support
-		iBody[ib].markers[m].supp_i.push_back(inear);
-		iBody[ib].markers[m].supp_j.push_back(jnear);
-		iBody[ib].markers[m].supp_k.push_back(knear);
-
 		// Set position
 		nearpos[eXDirection] = iBody[ib]._Owner->XPos[ijk[eXDirection]];
 		nearpos[eYDirection] = iBody[ib]._Owner->YPos[ijk[eYDirection]];
@@ -326,23 +476,78 @@ void ObjectManager::ibm_findSupport(int ib) {
 		nearpos[eZDirection] = iBody[ib]._Owner->ZPos[ijk[eZDirection]];
 #endif
 
+		// Kernel weights and cage test along each axis
+		std::vector<int> supportCage(ijk.begin(), ijk.end());
+		for (int d = 0; d < L_DIMS; d++) {
+			int lo = cage + 1, hi = -cage - 1;
+			for (int o = -cage; o <= cage; o++) {
+				double estimated = nearpos[d] + o * iBody[ib]._Owner->dh;
+				axisInside[d][o + cage] = 
+					(fabs(iBody[ib].markers[m].position[d] - estimated) / iBody[ib]._Owner->dh < 1.5 * iBody[ib].markers[m].dilation);
+				axisWeight[d][o + cage] = 
+					ibm_deltaKernel((estimated - iBody[ib].markers[m].position[d]) / iBody[ib]._Owner->dh, iBody[ib].markers[m].dilation);
+				if (axisInside[d][o + cage]) {
+					lo = std::min(lo, o);
+					hi = std::max(hi, o);
+				}
+			}
+			supportCage.push_back(lo);
+			supportCage.push_back(hi);
+		}
+
+		/* If the marker is still in the same voxel and its cage covers the 
+		 * same offsets then the support sites, their positions and their 
+		 * owning ranks are unchanged so only the delta values are refreshed. */
+		if (supportCage == iBody[ib].markers[m].supportCage) {
+			iBody[ib].markers[m].deltaval.clear();
+			for (size_t s = 0; s < iBody[ib].markers[m].supp_i.size(); s++) {
+				weights[eXDirection] = axisWeight[eXDirection][iBody[ib].markers[m].supp_i[s] - inear + cage];
+				weights[eYDirection] = axisWeight[eYDirection][iBody[ib].markers[m].supp_j[s] - jnear + cage];
+#if (L_DIMS == 3)
+				weights[eZDirection] = axisWeight[eZDirection][iBody[ib].markers[m].supp_k[s] - knear + cage];
+#endif
+				ibm_initialiseSupport(ib, m, weights);
+			}
+			continue;
+		}
+		iBody[ib].markers[m].supportCage = supportCage;
+		oldRanks.swap(iBody[ib].markers[m].support_rank);
+
+		// Clear all the previous (now invalid) support points
+		iBody[ib].markers[m].supp_i.clear();
+		iBody[ib].markers[m].supp_j.clear();
+		iBody[ib].markers[m].supp_k.clear();
+		iBody[ib].markers[m].supp_x.clear();
+		iBody[ib].markers[m].supp_y.clear();
+		iBody[ib].markers[m].supp_z.clear();
+		iBody[ib].markers[m].deltaval.clear();
+		iBody[ib].markers[m].support_rank.clear();
+
+		// Insert enclosing voxel into support
+		iBody[ib].markers[m].supp_i.push_back(inear);
+		iBody[ib].markers[m].supp_j.push_back(jnear);
+		iBody[ib].markers[m].supp_k.push_back(knear);
+
 		// Set the x-y-z of the support marker
 		iBody[ib].markers[m].supp_x.push_back(nearpos[eXDirection]);
 		iBody[ib].markers[m].supp_y.push_back(nearpos[eYDirection]);
 		iBody[ib].markers[m].supp_z.push_back(nearpos[eZDirection]);
 
+		// Weights of the first support point
+		for (int d = 0; d < L_DIMS; d++)
+			weights[d] = axisWeight[d][cage];
 
 		// Get the deltaval for the first support point
-		ibm_initialiseSupport(ib, m, nearpos);
+		ibm_initialiseSupport(ib, m, weights);
 
 		// Set rank of first support marker
 		iBody[ib].markers[m].support_rank.push_back(rank);
 
 		// Loop over surrounding 5 lattice sites and check if within support region
-		for (int i = inear - 5; i <= inear + 5; i++) {
-			for (int j = jnear - 5; j <= jnear + 5; j++) {
+		for (int i = inear - cage; i <= inear + cage; i++) {
+			for (int j = jnear - cage; j <= jnear + cage; j++) {
 #if (L_DIMS == 3)
-				for (int k = knear - 5; k <= knear + 5; k++)
+				for (int k = knear - cage; k <= knear + cage; k++)
 #else
 				int k = 0;
 #endif
@@ -358,15 +563,12 @@ void ObjectManager::ibm_findSupport(int ib) {
 					/* Find distance between Lagrange marker and proposed support point and
 					 * Check if inside the cage (convert to lattice units) */
 					if	(
-						(fabs(iBody[ib].markers[m].position[eXDirection] - estimated_position[eXDirection]) / iBody[ib]._Owner->dh
-						< 1.5 * iBody[ib].markers[m].dilation)
+						axisInside[eXDirection][i - inear + cage]
 						&&
-						(fabs(iBody[ib].markers[m].position[eYDirection] - estimated_position[eYDirection]) / iBody[ib]._Owner->dh
-						< 1.5 * iBody[ib].markers[m].dilation)
+						axisInside[eYDirection][j - jnear + cage]
 #if (L_DIMS == 3)
 						&&
-						(fabs(iBody[ib].markers[m].position[eZDirection] - estimated_position[eZDirection]) / iBody[ib]._Owner->dh
-						< 1.5 * iBody[ib].markers[m].dilation)
+						axisInside[eZDirection][k - knear + cage]
 #endif
 						&& GridUtils::isWithinDomain(estimated_position))
 					{
@@ -390,52 +592,42 @@ void ObjectManager::ibm_findSupport(int ib) {
 
 							// Initialise delta information for the set of support points including
 							// those not on this rank using estimated positions
-							ibm_initialiseSupport(ib, m, estimated_position);
+							weights[eXDirection] = axisWeight[eXDirection][i - inear + cage];
+							weights[eYDirection] = axisWeight[eYDirection][j - jnear + cage];
+#if (L_DIMS == 3)
+							weights[eZDirection] = axisWeight[eZDirection][k - knear + cage];
+#endif
+							ibm_initialiseSupport(ib, m, weights);
 
 							// Add owning rank as this one for now
 							iBody[ib].markers[m].support_rank.push_back(rank);
 
 #ifdef L_BUILD_FOR_MPI
-							/* Estimate which rank this point belongs to by seeing which
-							 * edge of the grid it is off. Use estimated rather than
-							 * actual positions. Compare to sender layer edges as if
-							 * it is on the recv layer it is belongs to the neighbour. */
-							if (estimated_position[eXDirection] < mpim->sender_layer_pos.X[eLeftMin])
-								estimated_rank_offset[eXDirection] = -1;
-							if (estimated_position[eXDirection] > mpim->sender_layer_pos.X[eRightMax])
-								estimated_rank_offset[eXDirection] = 1;
-							if (estimated_position[eYDirection] < mpim->sender_layer_pos.Y[eLeftMin])
-								estimated_rank_offset[eYDirection] = -1;
-							if (estimated_position[eYDirection] > mpim->sender_layer_pos.Y[eRightMax])
-								estimated_rank_offset[eYDirection] = 1;
-#if (L_DIMS == 3)
-							if (estimated_position[eZDirection] < mpim->sender_layer_pos.Z[eLeftMin])
-								estimated_rank_offset[eZDirection] = -1;
-							if (estimated_position[eZDirection] > mpim->sender_layer_pos.Z[eRightMax])
-								estimated_rank_offset[eZDirection] = 1;
-#endif
-
-							// Get MPI direction of the neighbour that owns this point
-							int owner_direction = GridUtils::getMpiDirection(estimated_rank_offset);
-							if (owner_direction != -1) {
-
-								// Owned by a neighbour so correct the support rank
-								iBody[ib].markers[m].support_rank.back() = mpim->neighbour_rank[owner_direction];
-							}
-
-							// Reset estimated rank offset
-							estimated_rank_offset[eXDirection] = 0;
-							estimated_rank_offset[eYDirection] = 0;
-#if (L_DIMS == 3)
-							estimated_rank_offset[eZDirection] = 0;
-#endif
+							/* Find the rank which owns this point from its estimated
+							 * position. Points on the recv layer belong to the 
+							 * neighbour whose core contains them. */
+							iBody[ib].markers[m].support_rank.back() = GridUtils::getRankfromPosition(estimated_position);
 #endif
 						}
 					}
 				}
 			}
 		}
+
+		/* If every site is owned by the same rank as before the comm classes 
+		 * keep their entries and only the off-rank sites need updating. */
+		if (iBody[ib].markers[m].support_rank != oldRanks) {
+			change = eSupportCrossed;
+		}
+		else {
+			if (change == eSupportUnchanged) change = eSupportMoved;
+			for (size_t s = 0; moved && s < oldRanks.size(); s++) {
+				if (oldRanks[s] != rank) (*moved)[m] = true;
+			}
+		}
 	}
+
+	return change;
 }
 
 
@@ -444,123 +636,200 @@ void ObjectManager::ibm_findSupport(int ib) {
 ///
 ///	\param	ib							body index
 ///	\param	m							marker index
-///	\param	estimated_position			position of support point
-void ObjectManager::ibm_initialiseSupport(int ib, int m, std::vector<double> &estimated_position)
+///	\param	weights						kernel weight of the support point along each axis
+void ObjectManager::ibm_initialiseSupport(int ib, int m, const double *weights)
 {
-
-	// Declarations
-	double dist_x, dist_y, delta_x, delta_y;	// Distances and deltas
-#if (L_DIMS == 3)
-	double dist_z, delta_z;
-#endif
-
-	// Distance between Lagrange marker and support node in lattice units
-	dist_x = (estimated_position[eXDirection] - iBody[ib].markers[m].position[eXDirection]) / iBody[ib]._Owner->dh;
-	dist_y = (estimated_position[eYDirection] - iBody[ib].markers[m].position[eYDirection]) / iBody[ib]._Owner->dh;
-#if (L_DIMS == 3)
-	dist_z = (estimated_position[eZDirection] - iBody[ib].markers[m].position[eZDirection]) / iBody[ib]._Owner->dh;
-#endif
-
-	// Store delta function value
-	delta_x = ibm_deltaKernel(dist_x, iBody[ib].markers[m].dilation);
-	delta_y = ibm_deltaKernel(dist_y, iBody[ib].markers[m].dilation);
-#if (L_DIMS == 3)
-	delta_z = ibm_deltaKernel(dist_z, iBody[ib].markers[m].dilation);
-#endif
-
 	// Calculate the delta value for the marker
-	iBody[ib].markers[m].deltaval.push_back(delta_x * delta_y
+	iBody[ib].markers[m].deltaval.push_back(weights[eXDirection] * weights[eYDirection]
 #if (L_DIMS == 3)
-		* delta_z
+		* weights[eZDirection]
 #endif	
 		);
 }
 
 
 // *****************************************************************************
-///	\brief	Interpolate velocity field onto markers
+///	\brief	Pack the support stencils of the markers on a level
+///
+///			Copies the support sites this rank owns of every valid marker 
+///			into the flat arrays used by the interpolate, spread and update 
+///			loops. Markers are packed in the order in which those loops used 
+///			to visit them so the sums are unchanged. Must be called whenever 
+///			the supports or their owning ranks change. The colouring of the 
+///			markers only depends on which sites they share so it is kept if 
+///			the supports have not been rebuilt.
 ///
 ///	\param	level		current grid level
-void ObjectManager::ibm_interpolate(int level) {
+///	\param	newSupport	whether any support on this rank has been rebuilt since the last pack
+void ObjectManager::ibm_packSupport(int level, bool newSupport) {
 
 	// Get rank
 	int rank = GridUtils::safeGetRank();
 
-	// Loop through all bodies
+	// Clear the pack (keeping the colours if still valid) and find the capacity of the stencils
+	IBSupportPack &pack = ibmSupportPack[level];
+	std::vector<int> colourStart, colourMarkers;
+	if (!newSupport) {
+		colourStart.swap(pack.colourStart);
+		colourMarkers.swap(pack.colourMarkers);
+	}
+	pack = IBSupportPack();
 	for (size_t ib = 0; ib < iBody.size(); ib++) {
-
-		// Only interpolate the bodies that exist on this grid level
 		if (iBody[ib]._Owner->level == level) {
+			for (auto m : iBody[ib].validMarkers) {
+				pack.stride = std::max(pack.stride, static_cast<int>(iBody[ib].markers[m].deltaval.size()));
+				pack.body.push_back(static_cast<int>(ib));
+				pack.marker.push_back(m);
+			}
+		}
+	}
+	pack.count.assign(pack.marker.size(), 0);
+	pack.site.assign(pack.marker.size() * pack.stride, 0);
+	pack.delta.assign(pack.marker.size() * pack.stride, 0.0);
+
+	// Fill the stencils
+	for (size_t p = 0; p < pack.marker.size(); p++) {
+		IBBody &body = iBody[pack.body[p]];
+		IBMarker &marker = body.markers[pack.marker[p]];
+		for (size_t s = 0; s < marker.deltaval.size(); s++) {
+
+			// Only sites this rank actually owns
+			if (marker.support_rank[s] != rank) continue;
+			size_t idx = p * pack.stride + pack.count[p];
+			pack.site[idx] = static_cast<int>(marker.supp_k[s] + marker.supp_j[s] * body._Owner->K_lim + marker.supp_i[s] * body._Owner->K_lim * body._Owner->M_lim);
+			pack.delta[idx] = marker.deltaval[s];
+			pack.count[p]++;
+		}
+	}
 
-			// Get grid sizes
-			size_t M_lim = iBody[ib]._Owner->M_lim;
-#if (L_DIMS == 3)
-			size_t K_lim = iBody[ib]._Owner->K_lim;
-#endif
+	// Key each support site by its grid region so that shared sites can be merged
+	std::vector<std::pair<long long, int>> keys;
+	for (size_t p = 0; p < pack.marker.size(); p++) {
+		long long region = iBody[pack.body[p]]._Owner->region_number;
+		for (int s = 0; s < pack.count[p]; s++)
+			keys.push_back(std::make_pair((region << 32) | pack.site[p * pack.stride + s], pack.body[p]));
+	}
 
-			// For each marker
-			for (auto m : iBody[ib].validMarkers) {
+	// Add the support sites this rank owns which belong to markers off-rank
+#ifdef L_BUILD_FOR_MPI
+	MpiManager *mpim = MpiManager::getInstance();
+	for (size_t i = 0; i < mpim->supportCommSupportSide[level].size(); i++) {
 
-				// Reset the values of interpolated velocity and density
-				std::fill(iBody[ib].markers[m].interpMom.begin(), iBody[ib].markers[m].interpMom.end(), 0.0);
-				iBody[ib].markers[m].interpRho = 0.0;
+		// Only do if body is on this grid level
+		int ib = bodyIDToIdx[mpim->supportCommSupportSide[level][i].bodyID];
+		if (iBody[ib]._Owner->level == level) {
+			GridObj *g = iBody[ib]._Owner;
+			const std::vector<int> &idx = mpim->supportCommSupportSide[level][i].supportIdx;
+			int id = idx[eZDirection] + idx[eYDirection] * g->K_lim + idx[eXDirection] * g->K_lim * g->M_lim;
+			keys.push_back(std::make_pair((static_cast<long long>(g->region_number) << 32) | id, ib));
+		}
+	}
+#endif
 
-				// Loop over support nodes
-				for (size_t i = 0; i < iBody[ib].markers[m].deltaval.size(); i++) {
+	// Keep one entry per distinct site
+	std::sort(keys.begin(), keys.end());
+	std::vector<long long> uniqueKey;
+	for (size_t n = 0; n < keys.size(); n++) {
+		if (n > 0 && keys[n].first == keys[n - 1].first) continue;
+		uniqueKey.push_back(keys[n].first);
+		pack.uniqueSite.push_back(static_cast<int>(keys[n].first & 0xFFFFFFFF));
+		pack.uniqueBody.push_back(keys[n].second);
+	}
 
-					// Only interpolate over data this rank actually owns at the moment
-					if (rank == iBody[ib].markers[m].support_rank[i]) {
+#ifdef L_ENABLE_OPENMP
+	// Reuse the colours if the supports are unchanged
+	if (!newSupport && !colourStart.empty() && colourMarkers.size() == pack.marker.size()) {
+		pack.colourStart.swap(colourStart);
+		pack.colourMarkers.swap(colourMarkers);
+		return;
+	}
 
+	// Distinct site of each stencil entry
+	std::vector<int> siteUnique(pack.site.size(), 0);
+	for (size_t p = 0; p < pack.marker.size(); p++) {
+		long long region = iBody[pack.body[p]]._Owner->region_number;
+		for (int s = 0; s < pack.count[p]; s++) {
+			long long key = (region << 32) | pack.site[p * pack.stride + s];
+			siteUnique[p * pack.stride + s] = static_cast<int>(std::lower_bound(uniqueKey.begin(), uniqueKey.end(), key) - uniqueKey.begin());
+		}
+	}
 
-						// Interpolate density
-#if (L_DIMS == 2)
-						iBody[ib].markers[m].interpRho += iBody[ib]._Owner->rho(
-								iBody[ib].markers[m].supp_i[i],
-								iBody[ib].markers[m].supp_j[i], M_lim) *
-								iBody[ib].markers[m].deltaval[i] * iBody[ib].markers[m].local_area;
-#else
-						iBody[ib].markers[m].interpRho += iBody[ib]._Owner->rho(
-								iBody[ib].markers[m].supp_i[i],
-								iBody[ib].markers[m].supp_j[i],
-								iBody[ib].markers[m].supp_k[i],
-								M_lim, K_lim) *
-								iBody[ib].markers[m].deltaval[i] * iBody[ib].markers[m].local_area;
+	// Colour the markers greedily in rounds. A marker joins the colour of the 
+	// current round if none of its sites has already been claimed in that round.
+	std::vector<int> colour(pack.marker.size(), -1);
+	std::vector<int> claimed(uniqueKey.size(), -1);
+	size_t nColoured = 0;
+	for (int c = 0; nColoured < pack.marker.size(); c++) {
+		pack.colourStart.push_back(static_cast<int>(pack.colourMarkers.size()));
+		for (size_t p = 0; p < pack.marker.size(); p++) {
+			if (colour[p] != -1) continue;
+
+			// Check for a conflict with a marker already in this colour
+			const int *site = &siteUnique[p * pack.stride];
+			bool conflict = false;
+			for (int s = 0; s < pack.count[p] && !conflict; s++)
+				conflict = (claimed[site[s]] == c);
+			if (conflict) continue;
+
+			// Claim its sites
+			for (int s = 0; s < pack.count[p]; s++)
+				claimed[site[s]] = c;
+			colour[p] = c;
+			pack.colourMarkers.push_back(static_cast<int>(p));
+			nColoured++;
+		}
+	}
+	pack.colourStart.push_back(static_cast<int>(pack.colourMarkers.size()));
 #endif
+}
 
-						// Loop over directions x y z
-						for (int dir = 0; dir < L_DIMS; dir++) {
 
-							// Read given velocity component from support node, multiply by delta function
-							// for that support node and sum to get interpolated velocity.
-#if (L_DIMS == 2)
+// *****************************************************************************
+///	\brief	Interpolate velocity field onto markers
+///
+///	\param	level		current grid level
+void ObjectManager::ibm_interpolate(int level) {
 
-							iBody[ib].markers[m].interpMom[dir] += iBody[ib]._Owner->rho(
-									iBody[ib].markers[m].supp_i[i],
-									iBody[ib].markers[m].supp_j[i], M_lim) *
-									iBody[ib]._Owner->u(
-									iBody[ib].markers[m].supp_i[i],
-									iBody[ib].markers[m].supp_j[i],
-									dir, M_lim, L_DIMS) * iBody[ib].markers[m].deltaval[i] * iBody[ib].markers[m].local_area;
-#else
-							iBody[ib].markers[m].interpMom[dir] += iBody[ib]._Owner->rho(
-									iBody[ib].markers[m].supp_i[i],
-									iBody[ib].markers[m].supp_j[i],
-									iBody[ib].markers[m].supp_k[i],
-									M_lim, K_lim) *
-									iBody[ib]._Owner->u(
-									iBody[ib].markers[m].supp_i[i],
-									iBody[ib].markers[m].supp_j[i],
-									iBody[ib].markers[m].supp_k[i],
-									dir, M_lim, K_lim, L_DIMS) * iBody[ib].markers[m].deltaval[i] * iBody[ib].markers[m].local_area;
+	// Send the values of support sites needed by off-rank markers while the local markers are done
+#ifdef L_BUILD_FOR_MPI
+	MpiManager::getInstance()->mpi_interpolateCommStart(level);
 #endif
-						}
-					}
-				}
-			}
-		}
-	}
 
+	// Loop through the packed markers on this level (each marker only writes to itself)
+	IBSupportPack &pack = ibmSupportPack[level];
+	int nMarkers = static_cast<int>(pack.marker.size());
+#ifdef L_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (int p = 0; p < nMarkers; p++) {
+
+		// Get the marker and its grid
+		IBMarker &marker = iBody[pack.body[p]].markers[pack.marker[p]];
+		GridObj *g = iBody[pack.body[p]]._Owner;
+		const int *site = &pack.site[p * pack.stride];
+		const double *delta = &pack.delta[p * pack.stride];
+
+		// Sum the interpolated density and momentum over the support sites
+		double interpRho = 0.0;
+		double interpMom[L_DIMS] = { 0.0 };
+		for (int s = 0; s < pack.count[p]; s++) {
+
+			// Interpolate density
+			double rho = g->rho[site[s]];
+			interpRho += rho * delta[s] * marker.local_area;
+
+			// Read given velocity component from support node, multiply by delta function
+			// for that support node and sum to get interpolated velocity.
+			for (int dir = 0; dir < L_DIMS; dir++)
+				interpMom[dir] += rho * g->u[site[s] * L_DIMS + dir] * delta[s] * marker.local_area;
+		}
 
+		// Store on the marker
+		std::fill(marker.interpMom.begin(), marker.interpMom.end(), 0.0);
+		for (int dir = 0; dir < L_DIMS; dir++)
+			marker.interpMom[dir] = interpMom[dir];
+		marker.interpRho = interpRho;
+	}
 
 	// Pass the necessary values between ranks
 #ifdef L_BUILD_FOR_MPI
@@ -608,57 +877,24 @@ void ObjectManager::ibm_computeForce(int level) {
 ///	\param	level		current grid level
 void ObjectManager::ibm_spread(int level) {
 
-	// Get rank
-	int rank = GridUtils::safeGetRank();
-
-	// Loop through bodies
-	for (size_t ib = 0; ib < iBody.size(); ib++) {
-
-		// Only spread the bodies that exist on this grid level
-		if (iBody[ib]._Owner->level == level) {
-
-			// Get volume scaling
-			double volWidth, volDepth;
-
-			// Get grid sizes
-			size_t M_lim = iBody[ib]._Owner->M_lim;
-			size_t K_lim = iBody[ib]._Owner->K_lim;
-
-			// Loop through markers
-			for (auto m : iBody[ib].validMarkers) {
-
-				// Loop through support sites
-				for (size_t s = 0; s < iBody[ib].markers[m].deltaval.size(); s++) {
-
-					// Only spread over data this rank actually owns at the moment
-					if (rank == iBody[ib].markers[m].support_rank[s]) {
-
-						// Set volume scaling
-						volWidth = iBody[ib].markers[m].epsilon;
-						volDepth = 1.0;
-#if (L_DIMS == 3)
-						volDepth = iBody[ib].markers[m].ds;
+	// Send the forces of off-rank support sites while the local markers are spread
+#ifdef L_BUILD_FOR_MPI
+	MpiManager::getInstance()->mpi_spreadCommStart(level);
 #endif
 
-						// Loop over directions x y z
-						for (size_t dir = 0; dir < L_DIMS; dir++) {
-
-							// Add contribution of current marker force to support node Cartesian force vector using delta values computed when support was computed
-							iBody[ib]._Owner->force_xyz(
-									iBody[ib].markers[m].supp_i[s],
-									iBody[ib].markers[m].supp_j[s],
-									iBody[ib].markers[m].supp_k[s],
-									dir, M_lim, K_lim, L_DIMS) -=
-									iBody[ib].markers[m].deltaval[s] *
-									iBody[ib].markers[m].force_xyz[dir] *
-									volWidth * volDepth *
-									iBody[ib].markers[m].ds;
-						}
-					}
-				}
-			}
-		}
+	// Loop through the packed markers on this level
+	IBSupportPack &pack = ibmSupportPack[level];
+#ifdef L_ENABLE_OPENMP
+	// Markers of the same colour share no support sites so can be spread concurrently
+	for (size_t c = 0; c + 1 < pack.colourStart.size(); c++) {
+#pragma omp parallel for schedule(static)
+		for (int n = pack.colourStart[c]; n < pack.colourStart[c + 1]; n++)
+			ibm_spreadMarker(pack, pack.colourMarkers[n]);
 	}
+#else
+	for (size_t p = 0; p < pack.marker.size(); p++)
+		ibm_spreadMarker(pack, static_cast<int>(p));
+#endif
 
 	// Pass the necessary values between ranks
 #ifdef L_BUILD_FOR_MPI
@@ -678,79 +914,63 @@ void ObjectManager::ibm_spread(int level) {
 
 
 // *****************************************************************************
-///	\brief	Update the macroscopic values at the support points
+///	\brief	Spread the restorative force of one packed marker onto its support
 ///
-///	\param	level		current grid level
-void ObjectManager::ibm_updateMacroscopic(int level) {
-
-	// Get rank
-	int rank = GridUtils::safeGetRank();
-
-	// Grid indices and type
-	int idx, jdx, kdx, id;
-	eType type_local;
-
-	// First do all support points that belong to markers that this rank owns
-	// Loop through all IBM bodies
-	for (size_t ib = 0; ib < iBody.size(); ib++) {
-
-		// Only do if body belongs to this grid level
-		if (iBody[ib]._Owner->level == level) {
-
-			// Loop through all markers
-			for (auto m : iBody[ib].validMarkers) {
-				for (size_t s = 0; s < iBody[ib].markers[m].deltaval.size(); s++) {
-
-					// Only do if this rank actually owns this support site
-					if (iBody[ib].markers[m].support_rank[s] == rank) {
-
-						// Get indices
-						idx = iBody[ib].markers[m].supp_i[s];
-						jdx = iBody[ib].markers[m].supp_j[s];
-						kdx = iBody[ib].markers[m].supp_k[s];
+///	\param	pack		packed support stencils of the current level
+///	\param	p			index of the marker in the pack
+void ObjectManager::ibm_spreadMarker(IBSupportPack &pack, int p) {
+
+	// Get the marker and its grid
+	IBMarker &marker = iBody[pack.body[p]].markers[pack.marker[p]];
+	GridObj *g = iBody[pack.body[p]]._Owner;
+	const int *site = &pack.site[p * pack.stride];
+	const double *delta = &pack.delta[p * pack.stride];
+
+	// Set volume scaling
+	double volWidth = marker.epsilon;
+	double volDepth = 1.0;
+#if (L_DIMS == 3)
+	volDepth = marker.ds;
+#endif
 
-						// Grid site index and type
-						id = kdx + jdx * iBody[ib]._Owner->K_lim + idx * iBody[ib]._Owner->K_lim * iBody[ib]._Owner->M_lim;
-						type_local = iBody[ib]._Owner->LatTyp[id];
+	// Loop through support sites
+	for (int s = 0; s < pack.count[p]; s++) {
 
-						// Update macroscopic value at this site
-						iBody[ib]._Owner->_LBM_macro_opt(idx, jdx, kdx, id, type_local);
-					}
-				}
-			}
+		// Add contribution of current marker force to support node Cartesian force vector using delta values computed when support was computed
+		for (int dir = 0; dir < L_DIMS; dir++) {
+			g->force_xyz[site[s] * L_DIMS + dir] -=
+				delta[s] * marker.force_xyz[dir] * volWidth * volDepth * marker.ds;
 		}
 	}
+}
 
-	// Now loop through any support sites this rank owns which belong to markers off-rank
-#ifdef L_BUILD_FOR_MPI
-	int ib;
-
-	// Get MPI manager instance
-	MpiManager *mpim = MpiManager::getInstance();
-
-	// Loop through any support sites this rank owns which belong to markers off-rank
-	for (size_t i = 0; i < mpim->supportCommSupportSide[level].size(); i++) {
-
-		// Get body idx
-		ib = bodyIDToIdx[mpim->supportCommSupportSide[level][i].bodyID];
-
-		// Only do if body is on this grid level
-		if (iBody[ib]._Owner->level == level) {
 
-			// Get indices
-			idx = mpim->supportCommSupportSide[level][i].supportIdx[eXDirection];
-			jdx = mpim->supportCommSupportSide[level][i].supportIdx[eYDirection];
-			kdx = mpim->supportCommSupportSide[level][i].supportIdx[eZDirection];
+// *****************************************************************************
+///	\brief	Update the macroscopic values at the support points
+///
+///	\param	level		current grid level
+void ObjectManager::ibm_updateMacroscopic(int level) {
 
-			// Grid site index and type
-			id = kdx + jdx * iBody[ib]._Owner->K_lim + idx * iBody[ib]._Owner->K_lim * iBody[ib]._Owner->M_lim;
-			type_local = iBody[ib]._Owner->LatTyp[id];
+	// Grid indices and type
+	int idx, jdx, kdx, id;
+	eType type_local;
 
-			// Update macroscopic value at this site
-			iBody[ib]._Owner->_LBM_macro_opt(idx, jdx, kdx, id, type_local);
-		}
+	// Loop through each distinct support site on this rank once, whether its 
+	// markers are owned by this rank or not
+	IBSupportPack &pack = ibmSupportPack[level];
+	for (size_t n = 0; n < pack.uniqueSite.size(); n++) {
+
+		// Grid site index, indices and type
+		GridObj *g = iBody[pack.uniqueBody[n]]._Owner;
+		id = pack.uniqueSite[n];
+		idx = id / (g->K_lim * g->M_lim);
+		jdx = (id / g->K_lim) % g->M_lim;
+		kdx = id % g->K_lim;
+		type_local = g->LatTyp[id];
+
+		// Update macroscopic value at this site
+		g->_LBM_macro_opt(idx, jdx, kdx, id, type_local);
 	}
-#endif
 }
 
 
@@ -795,77 +1015,138 @@ void ObjectManager::ibm_findEpsilon(int level) {
 
 			/* The Reproducing Kernel Particle Method (see Pinelli et al. 2010, JCP) requires suitable weighting
 			to be computed to ensure conservation while using the interpolation functions. Epsilon is this weighting.
-			We can use built-in libraries to solve the ensuing linear system in future. */
+			Only markers whose supports overlap interact so the system is sparse and solved iteratively. */
 
 			// Declarations
 			double Delta_I, Delta_J;
+			IBBody &body = (*iBodyPtr)[ib];
+			size_t numMarkers = body.markers.size();
+
+			//////////////////////////////////
+			//	Find interacting markers	//
+			//////////////////////////////////
+
+			/* Marker J only contributes to a_ij if its kernel reaches one of 
+			 * the support sites of marker I. The markers are binned into cells 
+			 * as wide as the largest kernel reach so that the candidates for J 
+			 * are found in the cells overlapping the support of I. */
+			double maxDilation = 0.0;
+			for (size_t m = 0; m < numMarkers; m++)
+				maxDilation = std::max(maxDilation, body.markers[m].dilation);
+			double reach = 1.5 * maxDilation * body.dh;
+			body.buildMarkerIndex(reach);
 
 			//////////////////////////////////
 			//	Build coefficient matrix A	//
 			//		with a_ij values.		//
 			//////////////////////////////////
 
-			// Initialise 2D std vector with zeros
-			std::vector< std::vector<double> > A((*iBodyPtr)[ib].markers.size(), std::vector<double>((*iBodyPtr)[ib].markers.size(), 0.0));
+			// Sparse rows of A (compressed row storage)
+			std::vector<int> rowStart(1, 0), cols;
+			std::vector<double> vals;
+			std::vector<int> candidates;
 
+			/* The support of I is a tensor product of a few coordinates along
+			 * each axis so the kernel of J is evaluated once per coordinate and 
+			 * its value at each support site formed as an outer product. */
+			std::vector<double> axisPos[L_DIMS], axisWeight[L_DIMS];
+			std::vector<int> axisIdx;
 
 			// Loop over support of marker I and integrate delta value multiplied by delta value of marker J.
-			for (size_t I = 0; I < (*iBodyPtr)[ib].markers.size(); I++) {
+			for (size_t I = 0; I < numMarkers; I++) {
+
+				// Box reached from the support of I (in the plane of the marker in 2D)
+				double lo[3], hi[3];
+				lo[eZDirection] = hi[eZDirection] = body.markers[I].position[eZDirection];
+				for (int d = 0; d < L_DIMS; d++) {
+					const std::vector<double>& supp = (d == eXDirection ? body.markers[I].supp_x : (d == eYDirection ? body.markers[I].supp_y : body.markers[I].supp_z));
+					lo[d] = hi[d] = body.markers[I].position[d];
+					for (size_t s = 0; s < supp.size(); s++) {
+						lo[d] = std::min(lo[d], supp[s]);
+						hi[d] = std::max(hi[d], supp[s]);
+					}
+					lo[d] -= reach;
+					hi[d] += reach;
+				}
+
+				// Distinct coordinates of the support of I along each axis
+				axisIdx.clear();
+				for (int d = 0; d < L_DIMS; d++) {
+					const std::vector<double>& supp = (d == eXDirection ? body.markers[I].supp_x : (d == eYDirection ? body.markers[I].supp_y : body.markers[I].supp_z));
+					axisPos[d].clear();
+					for (size_t s = 0; s < supp.size(); s++) {
+						size_t a = std::find(axisPos[d].begin(), axisPos[d].end(), supp[s]) - axisPos[d].begin();
+						if (a == axisPos[d].size()) axisPos[d].push_back(supp[s]);
+						axisIdx.push_back(static_cast<int>(a));
+					}
+				}
+				size_t nSupp = body.markers[I].deltaval.size();
+
+				// Gather candidate markers J in ascending order
+				candidates.clear();
+				body.markerIndex.findInBox(lo, hi, candidates);
+				std::sort(candidates.begin(), candidates.end());
 
 				// Loop over markers J
-				for (size_t J = 0; J < (*iBodyPtr)[ib].markers.size(); J++) {
+				for (size_t c = 0; c < candidates.size(); c++) {
+					size_t J = candidates[c];
+					double A_IJ = 0.0;
+
+					// Kernel of J along each axis at the support coordinates of I
+					for (int d = 0; d < L_DIMS; d++) {
+						axisWeight[d].resize(axisPos[d].size());
+						for (size_t a = 0; a < axisPos[d].size(); a++)
+							axisWeight[d][a] = ibm_deltaKernel((body.markers[J].position[d] - axisPos[d][a]) / body.dh, body.markers[J].dilation);
+					}
 
 					// Sum delta values evaluated for each support of I
-					for (size_t s = 0; s < (*iBodyPtr)[ib].markers[I].deltaval.size(); s++) {
+					for (size_t s = 0; s < nSupp; s++) {
 
-						Delta_I = (*iBodyPtr)[ib].markers[I].deltaval[s];
-#if (L_DIMS == 3)
-						Delta_J =
-							ibm_deltaKernel(
-							((*iBodyPtr)[ib].markers[J].position[eXDirection] - (*iBodyPtr)[ib].markers[I].supp_x[s]) / (*iBodyPtr)[ib].dh,
-							(*iBodyPtr)[ib].markers[J].dilation
-							) *
-							ibm_deltaKernel(
-							((*iBodyPtr)[ib].markers[J].position[eYDirection] - (*iBodyPtr)[ib].markers[I].supp_y[s]) / (*iBodyPtr)[ib].dh,
-							(*iBodyPtr)[ib].markers[J].dilation
-							) *
-							ibm_deltaKernel(
-							((*iBodyPtr)[ib].markers[J].position[eZDirection] - (*iBodyPtr)[ib].markers[I].supp_z[s]) / (*iBodyPtr)[ib].dh,
-							(*iBodyPtr)[ib].markers[J].dilation
-							);
-#else
+						Delta_I = body.markers[I].deltaval[s];
 						Delta_J =
-							ibm_deltaKernel(
-							((*iBodyPtr)[ib].markers[J].position[eXDirection] - (*iBodyPtr)[ib].markers[I].supp_x[s]) / (*iBodyPtr)[ib].dh,
-							(*iBodyPtr)[ib].markers[J].dilation
-							) *
-							ibm_deltaKernel(
-							((*iBodyPtr)[ib].markers[J].position[eYDirection] - (*iBodyPtr)[ib].markers[I].supp_y[s]) / (*iBodyPtr)[ib].dh,
-							(*iBodyPtr)[ib].markers[J].dilation
-							);
+							axisWeight[eXDirection][axisIdx[s]] *
+							axisWeight[eYDirection][axisIdx[nSupp + s]]
+#if (L_DIMS == 3)
+							* axisWeight[eZDirection][axisIdx[2 * nSupp + s]]
 #endif
+							;
+
 						// Multiply by local area (or volume in 3D)
-						A[I][J] += Delta_I * Delta_J * (*iBodyPtr)[ib].markers[I].local_area;
+						A_IJ += Delta_I * Delta_J * body.markers[I].local_area;
 					}
 
 					// Multiply by arc length between markers in lattice units
-					A[I][J] = A[I][J] * (*iBodyPtr)[ib].markers[J].ds;
+					A_IJ = A_IJ * body.markers[J].ds;
+
+					// Only store interacting pairs
+					if (A_IJ != 0.0) {
+						cols.push_back(static_cast<int>(J));
+						vals.push_back(A_IJ);
+					}
 				}
+				rowStart.push_back(static_cast<int>(cols.size()));
 			}
 
 			// Create vectors
-			std::vector<double> bVector((*iBodyPtr)[ib].markers.size(), 1.0);
+			std::vector<double> bVector(numMarkers, 1.0);
 
 			//////////////////
 			// Solve system //
 			//////////////////
 
+			// Flexible bodies change little between calls so start from the last epsilon
+			std::vector<double> guess;
+			if (body.isFlexible) {
+				for (size_t m = 0; m < numMarkers; m++)
+					guess.push_back(body.markers[m].epsilon);
+			}
+
 			// Solve linear system
-			std::vector<double> epsilon = GridUtils::solveLinearSystem(A, bVector);
+			std::vector<double> epsilon = GridUtils::solveSparseLinearSystem(rowStart, cols, vals, bVector, guess);
 
 			// Assign epsilon
-			for (size_t m = 0; m < (*iBodyPtr)[ib].markers.size(); m++) {
-				(*iBodyPtr)[ib].markers[m].epsilon = epsilon[m];
+			for (size_t m = 0; m < numMarkers; m++) {
+				body.markers[m].epsilon = epsilon[m];
 			}
 		}
 	}
@@ -906,25 +1187,42 @@ void ObjectManager::ibm_computeDs(int level) {
 			// Get grid spacing
 			dh = iBody[ib]._Owner->dh;
 
+			// Bin the markers into lattice-sized cells
+			iBody[ib].buildMarkerIndex(dh);
+			std::vector<int> shell;
+
 			// Now loop through all markers
 			for (size_t m = 0; m < iBody[ib].markers.size(); m++) {
 
 				// Set ds to high value
 				ds = 10.0;
 
-				// Loop through other markers
-				for (size_t n = 0; n < iBody[ib].markers.size(); n++) {
-
-					// Don't check itself
-					if (n != m) {
-
-						// Get grid normalised distance
-						dist = GridUtils::vecnorm(GridUtils::subtract(iBody[ib].markers[m].position, iBody[ib].markers[n].position)) / dh;
-
-						// Check if min of found so far
-						if (dist < ds)
-							ds = dist;
+				/* Search shells of cells outwards from the marker. Markers 
+				 * beyond shell r are at least r lattice spacings away so the
+				 * search stops once the nearest found is that close. */
+				for (int r = 0; r <= 10; r++) {
+					shell.clear();
+					iBody[ib].markerIndex.findInShell(iBody[ib].markers[m].position, r, shell);
+
+					// Loop through other markers
+					for (size_t c = 0; c < shell.size(); c++) {
+						size_t n = shell[c];
+
+						// Don't check itself
+						if (n != m) {
+
+							// Get grid normalised distance
+							dist = GridUtils::vecnorm(
+								iBody[ib].markers[m].position[eXDirection] - iBody[ib].markers[n].position[eXDirection],
+								iBody[ib].markers[m].position[eYDirection] - iBody[ib].markers[n].position[eYDirection],
+								iBody[ib].markers[m].position[eZDirection] - iBody[ib].markers[n].position[eZDirection]) / dh;
+
+							// Check if min of found so far
+							if (dist < ds)
+								ds = dist;
+						}
 					}
+					if (ds <= r) break;
 				}
 
 				// Set ds
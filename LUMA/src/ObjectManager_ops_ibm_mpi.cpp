@@ -45,47 +45,36 @@ void ObjectManager::ibm_updateMPIComms(int level) {
 // *****************************************************************************
 ///	\brief	Pass velocity values from support site which exist off-rank
 ///
+///			Completes the communication started by 
+///			MpiManager::mpi_interpolateCommStart and adds the off-rank 
+///			contributions to the interpolated values of the markers.
+///
 ///	\param	level		current grid level
 void ObjectManager::ibm_interpolateOffRankVels(int level) {
 
 	// Get the mpi manager instance
 	MpiManager *mpim = MpiManager::getInstance();
 
-	// Perform interpolation communication
-	std::vector<std::vector<double>> interpVels;
-	mpim->mpi_interpolateComm(level, interpVels);
-
-	// Create idx vector
-	std::vector<int> idx(mpim->num_ranks, 0);
+	// Wait for the interpolation communication
+	mpim->mpi_finishIBMComm(level);
+	MpiManager::IBCommPlanStruct &plan = mpim->ibm_comm_plan[level];
 
 	// Now interpolate these remaining values onto the marker
-	int ib, m, s, fromRank;
-	for (int i = 0; i < mpim->supportCommMarkerSide[level].size(); i++) {
+	int ib, m, s;
+	for (size_t i = 0; i < mpim->supportCommMarkerSide[level].size(); i++) {
 
-		// Get body idx
+		// Get IDs of support site
 		ib = bodyIDToIdx[mpim->supportCommMarkerSide[level][i].bodyID];
+		m = mpim->supportCommMarkerSide[level][i].markerIdx;
+		s = mpim->supportCommMarkerSide[level][i].supportID;
+		const double *buf = &plan.recvBuffer[plan.supportMarkerSide.slot[i] * (L_DIMS + 1)];
 
-		// Only do if body is on this grid level
-		if (iBody[ib]._Owner->level == level) {
-
-			// Get IDs of support site
-			m = mpim->supportCommMarkerSide[level][i].markerIdx;
-			s = mpim->supportCommMarkerSide[level][i].supportID;
-			fromRank = mpim->supportCommMarkerSide[level][i].rankComm;
+		// Interpolate density
+		iBody[ib].markers[m].interpRho += buf[0] * iBody[ib].markers[m].deltaval[s] * iBody[ib].markers[m].local_area;
 
-			// Interpolate density
-			iBody[ib].markers[m].interpRho += interpVels[fromRank][idx[fromRank]] * iBody[ib].markers[m].deltaval[s] * iBody[ib].markers[m].local_area;
-
-			// Shift index
-			idx[fromRank]++;
-
-			// Interpolate these values
-			for (int dir = 0; dir < L_DIMS; dir++)
-				iBody[ib].markers[m].interpMom[dir] += interpVels[fromRank][dir+idx[fromRank]] * iBody[ib].markers[m].deltaval[s] * iBody[ib].markers[m].local_area;
-
-			// Shift index
-			idx[fromRank] += L_DIMS;
-		}
+		// Interpolate these values
+		for (int dir = 0; dir < L_DIMS; dir++)
+			iBody[ib].markers[m].interpMom[dir] += buf[dir + 1] * iBody[ib].markers[m].deltaval[s] * iBody[ib].markers[m].local_area;
 	}
 }
 
@@ -93,46 +82,36 @@ void ObjectManager::ibm_interpolateOffRankVels(int level) {
 // *****************************************************************************
 ///	\brief	Spread forces to support site which exist off-rank
 ///
+///			Completes the communication started by 
+///			MpiManager::mpi_spreadCommStart and subtracts the off-rank 
+///			forces from the support sites this rank owns.
+///
 ///	\param	level		current grid level
 void ObjectManager::ibm_spreadOffRankForces(int level) {
 
 	// Get the mpi manager instance
 	MpiManager *mpim = MpiManager::getInstance();
 
-	// Perform interpolation communication
-	std::vector<std::vector<double>> spreadForces;
-	mpim->mpi_spreadComm(level, spreadForces);
-
-	// Create idx vector
-	std::vector<int> idx(mpim->num_ranks, 0);
-	std::vector<int> suppIdx(3, 0);
+	// Wait for the spreading communication
+	mpim->mpi_finishIBMComm(level);
+	MpiManager::IBCommPlanStruct &plan = mpim->ibm_comm_plan[level];
 
-	// Now interpolate these remaining values onto the marker
-	int ib, fromRank;
-	for (int i = 0; i < mpim->supportCommSupportSide[level].size(); i++) {
+	// Now spread these remaining values onto the support sites
+	int ib, id;
+	for (size_t i = 0; i < mpim->supportCommSupportSide[level].size(); i++) {
 
-		// Get body idx
+		// Get body idx and grid
 		ib = bodyIDToIdx[mpim->supportCommSupportSide[level][i].bodyID];
+		GridObj *g = iBody[ib]._Owner;
 
-		// Only do if body is on this grid level
-		if (iBody[ib]._Owner->level == level) {
-
-			// Get grid sizes
-			size_t M_lim = iBody[ib]._Owner->M_lim;
-			size_t K_lim = iBody[ib]._Owner->K_lim;
-
-			// Get IDs of support site
-			fromRank = mpim->supportCommSupportSide[level][i].rankComm;
-			suppIdx = mpim->supportCommSupportSide[level][i].supportIdx;
-
-			// Interpolate these values
-			for (int dir = 0; dir < L_DIMS; dir++)
-				iBody[ib]._Owner->force_xyz(suppIdx[eXDirection], suppIdx[eYDirection], suppIdx[eZDirection], dir, M_lim, K_lim, L_DIMS) -=
-						spreadForces[fromRank][idx[fromRank] + dir];
+		// Get grid site index
+		const std::vector<int> &suppIdx = mpim->supportCommSupportSide[level][i].supportIdx;
+		id = suppIdx[eZDirection] + suppIdx[eYDirection] * g->K_lim + suppIdx[eXDirection] * g->K_lim * g->M_lim;
+		const double *buf = &plan.recvBuffer[plan.supportSide.slot[i] * L_DIMS];
 
-			// Shift index
-			idx[fromRank] += L_DIMS;
-		}
+		// Spread these values
+		for (int dir = 0; dir < L_DIMS; dir++)
+			g->force_xyz[id * L_DIMS + dir] -= buf[dir];
 	}
 }
 
@@ -274,3 +253,29 @@ void ObjectManager::ibm_updateMarkers(int level) {
 		}
 	}
 }
+
+
+// *****************************************************************************
+///	\brief	Summarise which markers exist on this rank and who owns them
+///
+///			The MPI comm classes only need rebuilding when this changes or 
+///			when the owning ranks of the support sites of a marker change.
+///
+///	\param	level		current grid level
+///	\return	marker IDs, owning ranks and valid markers of the bodies on this level
+std::vector<int> ObjectManager::ibm_markerLayout(int level) {
+
+	std::vector<int> layout;
+	for (size_t ib = 0; ib < iBody.size(); ib++) {
+		if (iBody[ib]._Owner->level == level) {
+			layout.push_back(static_cast<int>(iBody[ib].markers.size()));
+			for (size_t m = 0; m < iBody[ib].markers.size(); m++) {
+				layout.push_back(iBody[ib].markers[m].id);
+				layout.push_back(iBody[ib].markers[m].owningRank);
+			}
+			layout.push_back(static_cast<int>(iBody[ib].validMarkers.size()));
+			layout.insert(layout.end(), iBody[ib].validMarkers.begin(), iBody[ib].validMarkers.end());
+		}
+	}
+	return layout;
+}
@@ -156,6 +156,9 @@ void ObjectManager::io_restart(eIOFlag IO_flag, int level) {
 		}
 
 
+		// Enough digits for the positions to be read back exactly
+		file.precision(17);
+
 		// Counters
 		size_t b, m, num_bod = iBody.size();
 
@@ -191,6 +194,22 @@ void ObjectManager::io_restart(eIOFlag IO_flag, int level) {
 
 		}
 
+		/* Write out the ds and epsilon of each marker after a key identifying 
+		 * the geometry and grid they were computed for so that they can be 
+		 * reused on restart rather than recomputed. */
+		for (b = 0; b < num_bod; b++) {
+
+			// Add a separator between bodies
+			file << "\t/\t";
+
+			// Key and number of markers
+			file << io_restartKey(static_cast<int>(b)) << "\t" << iBody[b].markers.size();
+
+			// Values for each marker
+			for (m = 0; m < iBody[b].markers.size(); m++)
+				file << "\t" << iBody[b].markers[m].ds << "\t" << iBody[b].markers[m].epsilon;
+		}
+
 		// Close file
 		file.close();
 
@@ -254,6 +273,12 @@ void ObjectManager::io_restart(eIOFlag IO_flag, int level) {
 					std::to_string(b) + " in the restart file. Exiting.", GridUtils::logfile);
 			}
 
+			// Marker data follows the next separator
+			std::getline(file,line_in,'/');
+			iss.clear();
+			iss.str(line_in);
+			iss.seekg(0); // Reset buffer position to start of buffer
+
 			// Read in marker data
 			for (m = 0; m < num_mark; m++) {
 
@@ -273,6 +298,39 @@ void ObjectManager::io_restart(eIOFlag IO_flag, int level) {
 
 		}
 
+		/* Read in the ds and epsilon of each body. They are only used if the 
+		 * key matches the one for the geometry and grid just read in. Restart 
+		 * files without these values simply lead to them being recomputed. */
+		ibmPrecomputeRestored = true;
+		for (b = 0; b < num_bod; b++) {
+
+			// Get next bit up to separator and put in buffer
+			unsigned long long key = 0;
+			if (!std::getline(file,line_in,'/')) {
+				ibmPrecomputeRestored = false;
+				break;
+			}
+			iss.clear();
+			iss.str(line_in);
+			iss.seekg(0); // Reset buffer position to start of buffer
+
+			// Check key and number of markers
+			size_t numMarkers = 0;
+			iss >> key >> numMarkers;
+			if (iss.fail() || key != io_restartKey(b) || iBody[b].markers.size() != numMarkers) {
+				ibmPrecomputeRestored = false;
+				break;
+			}
+
+			// Read in values
+			for (size_t n = 0; n < numMarkers; n++)
+				iss >> iBody[b].markers[n].ds >> iBody[b].markers[n].epsilon;
+			if (iss.fail()) {
+				ibmPrecomputeRestored = false;
+				break;
+			}
+		}
+
 		// Close file
 		file.close();
 
@@ -286,6 +344,48 @@ void ObjectManager::io_restart(eIOFlag IO_flag, int level) {
 }
 
 
+// *****************************************************************************
+///	\brief	Key identifying the geometry and grid of a body for restarts
+///
+///			Hashes (FNV-1a) everything that ds and epsilon of the markers held 
+///			by this rank depend on: the marker positions, kernel parameters 
+///			and the grid the body lives on.
+///
+///	\param	ib			body index
+///	\return	key for the body
+unsigned long long ObjectManager::io_restartKey(int ib) {
+
+	// Hash the bytes of a value into the key
+	unsigned long long key = 14695981039346656037ULL;
+	auto hash = [&key](const void *data, size_t bytes) {
+		const unsigned char *p = static_cast<const unsigned char *>(data);
+		for (size_t i = 0; i < bytes; i++) {
+			key ^= p[i];
+			key *= 1099511628211ULL;
+		}
+	};
+
+	// Grid the body lives on
+	GridObj *g = iBody[ib]._Owner;
+	int gridInfo[6] = { g->level, g->region_number, g->N_lim, g->M_lim, g->K_lim, GridUtils::safeGetRank() };
+	double gridPos[4] = { g->dh, g->XPos[0], g->YPos[0], g->ZPos[0] };
+	hash(gridInfo, sizeof(gridInfo));
+	hash(gridPos, sizeof(gridPos));
+
+	// Body and its markers
+	int bodyInfo[3] = { iBody[ib].id, iBody[ib].owningRank, static_cast<int>(iBody[ib].markers.size()) };
+	hash(bodyInfo, sizeof(bodyInfo));
+	for (size_t m = 0; m < iBody[ib].markers.size(); m++) {
+		IBMarker &marker = iBody[ib].markers[m];
+		double markerData[5] = { marker.position[eXDirection], marker.position[eYDirection], marker.position[eZDirection], marker.dilation, marker.local_area };
+		hash(&marker.id, sizeof(marker.id));
+		hash(markerData, sizeof(markerData));
+	}
+
+	return key;
+}
+
+
 // *****************************************************************************
 ///	\brief	Wrapper for writing body position data to VTK file
 ///
@@ -172,6 +172,9 @@ int main( int argc, char* argv[] )
 #ifdef L_BUILD_FOR_MPI
 	// Decompose the domain
 	mpim->mpi_gridbuild(gm);
+
+	// Ranks may have been renumbered when placed on nodes
+	rank = mpim->my_rank;
 	
 	// Get time of MPI initialisation
 	MPI_Barrier(mpim->world_comm);
@@ -195,13 +198,13 @@ int main( int argc, char* argv[] )
 	*/
 
 	// Create the first object in the hierarchy (level = 0)
-	GridObj *const Grids = new GridObj(0);
+	GridObj *Grids = new GridObj(0);
 
 
 	// Log file information
 	L_INFO("L0 Grid size = " + std::to_string(L_N) + "x" + std::to_string(L_M) + "x" + std::to_string(L_K), GridUtils::logfile);
 #ifdef L_BUILD_FOR_MPI
-	L_INFO("MPI size = " + std::to_string(L_MPI_XCORES) + "x" + std::to_string(L_MPI_YCORES) + "x" + std::to_string(L_MPI_ZCORES), GridUtils::logfile);
+	L_INFO("MPI size = " + std::to_string(mpim->dimensions[eXDirection]) + "x" + std::to_string(mpim->dimensions[eYDirection]) + "x" + std::to_string(mpim->dimensions[eZDirection]), GridUtils::logfile);
 	*GridUtils::logfile << "Coordinates on rank " << mpim->my_rank << " are (";
 	for (size_t d = 0; d < L_DIMS; d++)
 	{
@@ -332,6 +335,9 @@ int main( int argc, char* argv[] )
 
 #ifdef L_BUILD_FOR_MPI
 	
+	// Decide how often each level exchanges its halo and how much of it is sent
+	mpim->mpi_setExchangeIntervals();
+
 	// Compute buffer sizes
 	mpim->mpi_buffer_size();
 	
@@ -381,20 +387,8 @@ int main( int argc, char* argv[] )
 #endif
 
 #ifdef L_PROBE_OUTPUT
-#ifdef L_BUILD_FOR_MPI
-	for (int n = 0; n < mpim->num_ranks; n++)
-#endif
-	{
-		// Wait for rank accessing the file and only access if this rank's turn
-#ifdef L_BUILD_FOR_MPI
-		MPI_Barrier(mpim->world_comm);
-		if (mpim->my_rank == n)
-#endif
-		{
-			L_INFO("Initial probe write out...", GridUtils::logfile);
-			Grids->io_probeOutput();
-		}
-	}
+	L_INFO("Initial probe write out...", GridUtils::logfile);
+	Grids->io_probeOutput();
 #endif	// L_PROBE_OUTPUT
 
 #ifdef L_BUILD_FOR_MPI
@@ -419,10 +413,8 @@ int main( int argc, char* argv[] )
 	*/
 	do {
 
-		// Synchronise MPI processes before next time step starts
-#ifdef L_BUILD_FOR_MPI
-		MPI_Barrier(mpim->world_comm);
-#endif
+		/* MPI processes are not synchronised between time steps. Each rank 
+		 * only waits for its neighbours during the halo exchange. */
 
 #ifdef L_SHOW_TIME_TO_COMPLETE
 		// Start clock for timing outer loop
@@ -447,7 +439,8 @@ int main( int argc, char* argv[] )
 		if (Grids->t % L_GRID_OUT_FREQ == 0)
 		{
 #ifdef L_BUILD_FOR_MPI
-			MPI_Barrier(mpim->world_comm);
+			// Report the wait avoided by not synchronising
+			mpim->mpi_reportWaitSaved();
 #endif
 			// Write out the time an outer loop is taking to the log file
 			L_INFO("Outer loop taking " + std::to_string(outer_loop_time) + 
@@ -525,26 +518,8 @@ int main( int argc, char* argv[] )
 #ifdef L_PROBE_OUTPUT
 		if (Grids->t % L_PROBE_OUT_FREQ == 0)
 		{
-
-#ifdef L_BUILD_FOR_MPI
-			for (int n = 0; n < mpim->num_ranks; n++)
-#endif
-			{
-
-				// Wait for rank accessing the file and only access if this rank's turn
-#ifdef L_BUILD_FOR_MPI
-				MPI_Barrier(mpim->world_comm);
-				if (mpim->my_rank == n) 
-#endif
-				{
-
-					L_INFO("Probe write out...", GridUtils::logfile);
-					Grids->io_probeOutput();
-
-				}
-
-			}
-
+			L_INFO("Probe write out...", GridUtils::logfile);
+			Grids->io_probeOutput();
 		}
 #endif
 
@@ -558,6 +533,16 @@ int main( int argc, char* argv[] )
 			Grids->io_restart(eWrite);
 		}
 
+		//////////////////////////
+		// Dynamic Load Balance //
+		//////////////////////////
+#if (defined L_BUILD_FOR_MPI && defined L_MPI_DYNAMIC_BALANCE)
+		if (Grids->t % L_MPI_BALANCE_FREQ == 0)
+		{
+			// Hierarchy is rebuilt if the domain is re-decomposed
+			if (mpim->mpi_dynamicBalance(gm)) GridUtils::getGrid(0, 0, Grids);
+		}
+#endif
 
 #ifdef L_SHOW_TIME_TO_COMPLETE
 		// Update outer loop time (inc. effects of writing out for accuracy)
@@ -569,6 +554,16 @@ int main( int argc, char* argv[] )
 	// Loop End
 	} while (Grids->t < L_TOTAL_TIMESTEPS);
 
+	// Complete outstanding diagnostics
+#ifdef L_PROBE_OUTPUT
+	Grids->io_probeFlush();
+#endif
+#ifdef L_BUILD_FOR_MPI
+	mpim->mpi_completeWaitReport();
+	L_INFO("Time spent waiting for non-blocking diagnostics = " + 
+		std::to_string(mpim->diagnostics_wait_time * 1000) + "ms.", GridUtils::logfile);
+#endif
+
 
 	/*
 	****************************************************************************